@@ -21,12 +21,15 @@
  ****************************************************************************/
 static void ApplyBoundaryCondition(const int, const int, int [restrict][LIMIT],
         const int, Space *, const Model *);
-static void EnforceZeroGradient(const Real [restrict], Real [restrict]);
+static void EnforceZeroGradient(const int, const int, Real *const [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void TreatBoundary(const int tn, Space *space, const Model *model)
 {
+    if (tn == space->field.tc) { /* cached primitives become outdated */
+        space->field.tc = NONE;
+    }
     /*
      * Internal boundary treatment
      * Should be performed first to ensure stencils for diffusive flux
@@ -61,13 +64,48 @@ void TreatBoundary(const int tn, Space *space, const Model *model)
             ApplyBoundaryCondition(p, r, box, tn, space, model);
         }
     }
+    RefreshPrimitiveCache(tn, space, model);
+    return;
+}
+/*
+ * The cache covers every node of the field. Expressions are the same as in
+ * MapPrimitive to keep cached values identical to recomputed ones.
+ */
+void RefreshPrimitiveCache(const int tn, Space *space, const Model *model)
+{
+    Field *const field = &(space->field);
+    if (NULL == field->Uc[0]) {
+        return;
+    }
+    const Partition *const part = &(space->part);
+    const int totN = part->n[X] * part->n[Y] * part->n[Z];
+    const Real *const rho = field->U[tn][0];
+    const Real *const rhoU = field->U[tn][1];
+    const Real *const rhoV = field->U[tn][2];
+    const Real *const rhoW = field->U[tn][3];
+    const Real *const rhoE = field->U[tn][4];
+    Real *const *const Uc = field->Uc;
+    const Real gamma = model->gamma;
+    const Real gasR = model->gasR;
+#pragma omp parallel for schedule(static)
+    for (int idx = 0; idx < totN; ++idx) {
+        const Real p = (rhoE[idx] - 0.5 * (rhoU[idx] * rhoU[idx] + rhoV[idx] * rhoV[idx] +
+                    rhoW[idx] * rhoW[idx]) / rho[idx]) * (gamma - 1.0);
+        Uc[0][idx] = rho[idx];
+        Uc[1][idx] = rhoU[idx] / rho[idx];
+        Uc[2][idx] = rhoV[idx] / rho[idx];
+        Uc[3][idx] = rhoW[idx] / rho[idx];
+        Uc[4][idx] = p;
+        Uc[5][idx] = p / (rho[idx] * gasR);
+    }
+    field->tc = tn;
     return;
 }
 static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][LIMIT],
         const int tn, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Real *const *const Uf = space->field.U[tn];
     const Real zero = 0.0;
     const Real UoGiven[DIMUo] = { /* specified primitive values of current boundary */
         part->varBC[p][0],
@@ -78,20 +116,25 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
         part->varBC[p][5]};
     const IntVec N = {part->N[p][X], part->N[p][Y], part->N[p][Z]};
     const IntVec LN = {part->m[X] * N[X], part->m[Y] * N[Y], part->m[Z] * N[Z]};
-    Real *restrict UG = NULL;
-    Real *restrict UI = NULL;
-    Real *restrict UO = NULL;
-    Real *restrict Uh = NULL;
-    int idxG = 0; /* index at ghost node */
-    int idxI = 0; /* index at image node */
-    int idxO = 0; /* index at boundary point */
-    int idxh = 0; /* index at neighbouring point */
-    Real UoG[DIMUo] = {zero};
-    Real UoI[DIMUo] = {zero};
-    Real UoO[DIMUo] = {zero};
-    Real Uoh[DIMUo] = {zero};
+    /*
+     * Nodes of a box layer only read nodes of inner layers, hence they are
+     * treated independently by threads.
+     */
+#pragma omp parallel for collapse(2) schedule(static)
     for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
         for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+            Real UG[DIMU] = {zero};
+            Real UI[DIMU] = {zero};
+            Real UO[DIMU] = {zero};
+            Real Uh[DIMU] = {zero};
+            int idxG = 0; /* index at ghost node */
+            int idxI = 0; /* index at image node */
+            int idxO = 0; /* index at boundary point */
+            int idxh = 0; /* index at neighbouring point */
+            Real UoG[DIMUo] = {zero};
+            Real UoI[DIMUo] = {zero};
+            Real UoO[DIMUo] = {zero};
+            Real Uoh[DIMUo] = {zero};
             for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                 /*
                  * Apply boundary conditions for current node, always remember
@@ -100,49 +143,46 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                  */
                 if (0 != r) { /* treat ghost layers */
                     idxG = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    UG = node[idxG].U[tn];
                     switch (part->typeBC[p]) {
                         case SLIPWALL:
                             /* fall through */
                         case NOSLIPWALL:
                             idxO = IndexNode(k - r*N[Z], j - r*N[Y], i - r*N[X], part->n[Y], part->n[X]);
-                            UO = node[idxO].U[tn];
+                            LoadU(idxO, Uf, UO);
                             MapPrimitive(model->gamma, model->gasR, UO, UoO);
                             idxI = IndexNode(k - 2*r*N[Z], j - 2*r*N[Y], i - 2*r*N[X], part->n[Y], part->n[X]);
-                            UI = node[idxI].U[tn];
+                            LoadU(idxI, Uf, UI);
                             MapPrimitive(model->gamma, model->gasR, UI, UoI);
                             DoMethodOfImage(UoI, UoO, UoG);
                             UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
                             MapConservative(model->gamma, UoG, UG);
+                            StoreU(idxG, UG, Uf);
                             break;
                         case PERIODIC:
                             idxh = IndexNode(k - LN[Z], j - LN[Y], i - LN[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            EnforceZeroGradient(Uh, UG);
+                            EnforceZeroGradient(idxh, idxG, Uf);
                             break;
                         default:
                             idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                            Uh = node[idxh].U[tn];
-                            EnforceZeroGradient(Uh, UG);
+                            EnforceZeroGradient(idxh, idxG, Uf);
                             break;
                     }
                     continue;
                 }
                 idxO = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                UO = node[idxO].U[tn];
                 switch (part->typeBC[p]) { /* treat physical boundary */
                     case INFLOW:
                         MapConservative(model->gamma, UoGiven, UO);
+                        StoreU(idxO, UO, Uf);
                         break;
                     case OUTFLOW:
                         /* Calculate inner neighbour nodes according to normal vector direction. */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
-                        EnforceZeroGradient(Uh, UO);
+                        EnforceZeroGradient(idxh, idxO, Uf);
                         break;
                     case SLIPWALL: /* zero-gradient for scalar and tangential component, zero for normal component */
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        LoadU(idxh, Uf, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = (!N[X]) * Uoh[1];
                         UoO[2] = (!N[Y]) * Uoh[2];
@@ -155,10 +195,11 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         }
                         UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
                         MapConservative(model->gamma, UoO, UO);
+                        StoreU(idxO, UO, Uf);
                         break;
                     case NOSLIPWALL:
                         idxh = IndexNode(k - N[Z], j - N[Y], i - N[X], part->n[Y], part->n[X]);
-                        Uh = node[idxh].U[tn];
+                        LoadU(idxh, Uf, Uh);
                         MapPrimitive(model->gamma, model->gasR, Uh, Uoh);
                         UoO[1] = zero;
                         UoO[2] = zero;
@@ -171,6 +212,7 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
                         }
                         UoO[0] = UoO[4] / (UoO[5] * model->gasR); /* compute density */
                         MapConservative(model->gamma, UoO, UO);
+                        StoreU(idxO, UO, Uf);
                         break;
                     case PERIODIC:
                         /* no treatment needed since the boundary participates normal computation */
@@ -183,10 +225,10 @@ static void ApplyBoundaryCondition(const int p, const int r, int box[restrict][L
     }
     return;
 }
-static void EnforceZeroGradient(const Real Uh[restrict], Real U[restrict])
+static void EnforceZeroGradient(const int idxh, const int idx, Real *const Uf[restrict])
 {
     for (int n = 0; n < DIMU; ++n) {
-        U[n] = Uh[n];
+        Uf[n][idx] = Uf[n][idxh];
     }
     return;
 }
@@ -30,6 +30,16 @@
  *      Apply boundary conditions and treatments for the field variable.
  */
 extern void TreatBoundary(const int tn, Space *, const Model *);
+/*
+ * Primitive cache
+ *
+ * Function
+ *      Fill the primitive cache with the primitive variables of a time level
+ *      once its boundary treatment is completed. Kernels reading the same
+ *      time level afterwards take primitives from the cache instead of
+ *      recomputing them. Nothing is done if the cache is disabled.
+ */
+extern void RefreshPrimitiveCache(const int tn, Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
@@ -69,20 +69,36 @@ static void GenerateCaseSettingFile(void)
     fprintf(fp, "1                  # space data writing frequency (int; 0: inf)\n");
     fprintf(fp, "1                  # data streamer (int; 0: ParaView; 1: Ensight)\n");
     fprintf(fp, "time end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "data format begin\n");
+    fprintf(fp, "0                  # ParaView field data (int; 0: ascii; 1: binary)\n");
+    fprintf(fp, "data format end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "restart format begin\n");
+    fprintf(fp, "0                  # restart data (int; 0: visualization data; 1: native checkpoint)\n");
+    fprintf(fp, "restart format end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "data queue begin\n");
+    fprintf(fp, "0                  # snapshot staging buffers (int; 0: synchronous writing)\n");
+    fprintf(fp, "data queue end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "numerical begin\n");
-    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3;)\n");
+    fprintf(fp, "1                  # temporal scheme (int; 0: RK2; 1: RK3; 2: low-storage RK3)\n");
     fprintf(fp, "1                  # spatial scheme (int; 0: WENO3; 1: WENO5;)\n");
-    fprintf(fp, "0                  # dimension scheme (int; 0: dim split; 1: dim by dim)\n");
+    fprintf(fp, "0                  # dimension scheme (int; 0: dim split; 1: dim by dim; 2: alternating dim split)\n");
     fprintf(fp, "0                  # Jacobian average (int; 0: Arithmetic; 1: Roe)\n");
     fprintf(fp, "0                  # flux splitting method (int; 0: LLF; 1: SW)\n");
     fprintf(fp, "0                  # phase interaction (int; 0: F; 1: FSI; 2: FSI+SSI)\n");
     fprintf(fp, "1                  # ibm reconstruction layers (int; 0: inf)\n");
     fprintf(fp, "numerical end\n");
+    fprintf(fp, "#\n");
+    fprintf(fp, "performance begin\n");
+    fprintf(fp, "0                  # primitive cache (int; 0: off; 1: on)\n");
+    fprintf(fp, "performance end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Material Properties <<\n");
@@ -283,6 +299,12 @@ static void GenerateCaseGeometryFile(void)
     fprintf(fp, "1                  # analytical polyhedron (int)\n");
     fprintf(fp, "1                  # triangulated polyhedron (int)\n");
     fprintf(fp, "count end\n");
+    fprintf(fp, "polyhedron weld begin\n");
+    fprintf(fp, "0                  # vertex weld tolerance (real; <= 0: exact match)\n");
+    fprintf(fp, "polyhedron weld end\n");
+    fprintf(fp, "polyhedron distance field begin\n");
+    fprintf(fp, "0                  # samples along the longest side (int; 0: off)\n");
+    fprintf(fp, "polyhedron distance field end\n");
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                   >> Geometry Information <<\n");
@@ -84,6 +84,26 @@ static void ReadCaseSettingData(Time *time, Space *space, Model *model)
             Sread(fp, 1, "%d", &(model->ibmLayer));
             continue;
         }
+        if (0 == strncmp(str, "data format begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->dataFormat));
+            continue;
+        }
+        if (0 == strncmp(str, "restart format begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->restartFormat));
+            continue;
+        }
+        if (0 == strncmp(str, "data queue begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(time->dataQueue));
+            continue;
+        }
+        if (0 == strncmp(str, "performance begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(model->pCache));
+            continue;
+        }
         if (0 == strncmp(str, "material begin", sizeof str)) {
             ++nentry;
             Sread(fp, 1, "%d", &(model->mid));
@@ -236,13 +256,24 @@ static void ReadGeometrySettingData(Geometry *const geo)
     FILE *fp = Fopen(fname, "r");
     String str = {'\0'}; /* store the current read line */
     int nentry = 0; /* entry count */
+    const char *fmtI = ParseFormat("%lg");
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "count begin", sizeof str)) {
             ++nentry;
             Sread(fp, 1, "%d", &(geo->sphN));
             Sread(fp, 1, "%d", &(geo->stlN));
-            break;
+            continue;
+        }
+        if (0 == strncmp(str, "polyhedron weld begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, fmtI, &(geo->weld));
+            continue;
+        }
+        if (0 == strncmp(str, "polyhedron distance field begin", sizeof str)) {
+            /* optional entry do not increase entry count */
+            Sread(fp, 1, "%d", &(geo->dfN));
+            continue;
         }
     }
     fclose(fp);
@@ -406,6 +437,9 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "maximum computing steps: %d\n", time->stepN);
     fprintf(fp, "space data writing frequency: %d\n", time->dataW[PROSD]);
     fprintf(fp, "data streamer: %d\n", time->dataStreamer);
+    fprintf(fp, "data format: %d\n", time->dataFormat);
+    fprintf(fp, "restart format: %d\n", time->restartFormat);
+    fprintf(fp, "data queue: %d\n", time->dataQueue);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                        >> Numerical Method <<\n");
@@ -418,6 +452,7 @@ static void WriteVerifyData(const Time *time, const Space *space, const Model *m
     fprintf(fp, "flux splitting method: %d\n", model->fluxSplit);
     fprintf(fp, "phase interaction: %d\n", model->psi);
     fprintf(fp, "ibm reconstruction layers: %d\n", model->ibmLayer);
+    fprintf(fp, "primitive cache: %d\n", model->pCache);
     fprintf(fp, "#------------------------------------------------------------------------------\n");
     fprintf(fp, "#\n");
     fprintf(fp, "#                       >> Material Properties <<\n");
@@ -76,40 +76,6 @@ static ConvectiveFluxComputer ComputeConvectiveFlux[DIMS] = {
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void SymmetricAverage(const int averager, const Real gamma,
-        const Real UL[restrict], const Real UR[restrict], Real Uo[restrict])
-{
-    const Real rhoL = UL[0];
-    const Real uL = UL[1] / UL[0];
-    const Real vL = UL[2] / UL[0];
-    const Real wL = UL[3] / UL[0];
-    const Real hTL = (UL[4] / UL[0]) * gamma - 0.5 * (uL * uL + vL * vL + wL * wL) * (gamma - 1.0);
-    const Real rhoR = UR[0];
-    const Real uR = UR[1] / UR[0];
-    const Real vR = UR[2] / UR[0];
-    const Real wR = UR[3] / UR[0];
-    const Real hTR = (UR[4] / UR[0]) * gamma - 0.5 * (uR * uR + vR * vR + wR * wR) * (gamma - 1.0);
-    Real D = 0.0;
-    switch (averager) {
-        case 0: /* arithmetic mean */
-            Uo[1] = 0.5 * (uL + uR); /* u average */
-            Uo[2] = 0.5 * (vL + vR); /* v average */
-            Uo[3] = 0.5 * (wL + wR); /* w average */
-            Uo[4] = 0.5 * (hTL + hTR); /* hT average */
-            break;
-        case 1: /* Roe average */
-            D = sqrt(rhoR / rhoL);
-            Uo[1] = (uL + D * uR) / (1.0 + D); /* u average */
-            Uo[2] = (vL + D * vR) / (1.0 + D); /* v average */
-            Uo[3] = (wL + D * wR) / (1.0 + D); /* w average */
-            Uo[4] = (hTL + D * hTR) / (1.0 + D); /* hT average */
-            break;
-        default:
-            break;
-    }
-    Uo[5] = sqrt((gamma - 1.0) * (Uo[4] - 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]))); /* the speed of sound */
-    return;
-}
 void Eigenvalue(const int s, const Real Uo[restrict], Real Lambda[restrict])
 {
     Lambda[0] = Uo[s+1] - Uo[5];
@@ -311,6 +277,18 @@ Real ComputeTemperature(const Real cv, const Real U[restrict])
 {
     return (U[4] - 0.5 * (U[1] * U[1] + U[2] * U[2] + U[3] * U[3]) / U[0]) / (U[0] * cv);
 }
+void MaxCharacteristicSpeed(const Real gamma, const Real gasR, const Real Uo[restrict],
+        Real Vmax[restrict])
+{
+    const Real c = sqrt(gamma * gasR * Uo[5]); /* speed of sound */
+    for (int s = 0; s < DIMS; ++s) {
+        const Real Vn = fabs(Uo[s+1]) + c;
+        if (Vmax[s] < Vn) {
+            Vmax[s] = Vn;
+        }
+    }
+    return;
+}
 void MapConservative(const Real gamma, const Real Uo[restrict], Real U[restrict])
 {
     U[0] = Uo[0];
@@ -320,6 +298,34 @@ void MapConservative(const Real gamma, const Real Uo[restrict], Real U[restrict]
     U[4] = 0.5 * Uo[0] * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]) + Uo[4] / (gamma - 1.0);
     return;
 }
+void LoadU(const int idx, Real *const Uf[restrict], Real U[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        U[n] = Uf[n][idx];
+    }
+    return;
+}
+void StoreU(const int idx, const Real U[restrict], Real *const Uf[restrict])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        Uf[n][idx] = U[n];
+    }
+    return;
+}
+void LoadPrimitive(const int tn, const int idx, const Field *const field,
+        const Model *model, Real Uo[restrict])
+{
+    if (tn == field->tc) {
+        for (int n = 0; n < DIMUo; ++n) {
+            Uo[n] = field->Uc[n][idx];
+        }
+        return;
+    }
+    Real U[DIMU] = {0.0};
+    LoadU(idx, field->U[tn], U);
+    MapPrimitive(model->gamma, model->gasR, U, Uo);
+    return;
+}
 int IndexNode(const int k, const int j, const int i, const int jMax, const int iMax)
 {
     return (k * jMax + j) * iMax + i;
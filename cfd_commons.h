@@ -23,14 +23,6 @@
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
-/*
- * Average method
- *
- * Function
- *      Compute averaged variables at interface.
- */
-extern void SymmetricAverage(const int averager, const Real gamma,
-        const Real UL[restrict], const Real UR[restrict], Real Uo[restrict]);
 /*
  * Jacobian matrices, eigenvalues, and eigenvectors
  *
@@ -64,6 +56,15 @@ extern Real PrandtlNumber(void);
 extern void MapPrimitive(const Real gamma, const Real gasR, const Real U[restrict], Real Uo[restrict]);
 extern Real ComputePressure(const Real gamma, const Real U[restrict]);
 extern Real ComputeTemperature(const Real cv, const Real U[restrict]);
+/*
+ * Characteristic speeds
+ *
+ * Function
+ *      Update the maximum characteristic speeds |Vs| + c of each direction
+ *      with the primitive vector of a node.
+ */
+extern void MaxCharacteristicSpeed(const Real gamma, const Real gasR, const Real Uo[restrict],
+        Real Vmax[restrict]);
 /*
  * Compute and update conservative variable vector
  *
@@ -71,6 +72,25 @@ extern Real ComputeTemperature(const Real cv, const Real U[restrict]);
  *      Compute conservative variable vector according to primitive vector.
  */
 extern void MapConservative(const Real gamma, const Real Uo[restrict], Real U[restrict]);
+/*
+ * Field data access
+ *
+ * Function
+ *      Gather the conservative vector of a node from the variable arrays of
+ *      a time level, or scatter a conservative vector back into them.
+ */
+extern void LoadU(const int idx, Real *const Uf[restrict], Real U[restrict]);
+extern void StoreU(const int idx, const Real U[restrict], Real *const Uf[restrict]);
+/*
+ * Primitive data access
+ *
+ * Function
+ *      Obtain the primitive vector of a node at a time level in the layout
+ *      of MapPrimitive, from the primitive cache if it holds the time level,
+ *      otherwise from the conservative variables.
+ */
+extern void LoadPrimitive(const int tn, const int idx, const Field *const,
+        const Model *, Real Uo[restrict]);
 /*
  * Index math
  *
@@ -68,6 +68,15 @@ static void SetNodeNumber(Space *space, Model *model)
         default:
             break;
     }
+    /* set time levels required by temporal scheme */
+    switch (model->tScheme) {
+        case RKTHREE:
+            space->field.tl = DIMT;
+            break;
+        default: /* two-register schemes */
+            space->field.tl = DIMT - 1;
+            break;
+    }
     /*
      * Number of ghost node layers of each spatial dimension.
      * Note that the global boundary accounts for one ghost layer,
@@ -78,7 +87,7 @@ static void SetNodeNumber(Space *space, Model *model)
         part->ng[s] = part->gl - 1;
     }
     /* adjust according to dimension collapse */
-    if (OPTSPLIT == model->multidim) {
+    if (OPTBYOPT != model->multidim) {
         switch (part->collapse) {
             case COLLAPSEN:
                 break;
@@ -0,0 +1,368 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#define _POSIX_C_SOURCE 200809L /* memory mapped files, set before any header */
+#include "checkpoint.h"
+#include <stdio.h> /* standard library for input and output */
+#include <string.h> /* manipulating strings */
+#include <stdint.h> /* fixed width integer types */
+#include <fcntl.h> /* file control options */
+#include <unistd.h> /* POSIX operating system interface */
+#include <sys/stat.h> /* file status */
+#include <sys/mman.h> /* memory management */
+#include "computational_geometry.h"
+#include "cfd_commons.h"
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    CKVERSION = 2, /* layout version of checkpoint files */
+    CKALIGN = 8, /* blocks are padded to a multiple of the checksum word */
+    CKORDER = 0x01020304, /* byte order mark */
+    CKORDERSWAP = 0x04030201, /* byte order mark read on a machine of the other byte order */
+} CheckpointConst;
+
+typedef struct {
+    char magic[8]; /* file signature */
+    uint32_t order; /* byte order mark */
+    uint32_t version; /* layout version */
+    uint32_t intSize; /* size of int data */
+    uint32_t realSize; /* size of real data */
+    int dimU; /* number of conservative variables */
+    IntVec n; /* number of nodes in each direction */
+    int totN; /* total number of geometries */
+    int sphN; /* number of analytical polyhedrons */
+    int stepC; /* step number count */
+    int dataC; /* data writing count */
+    Real now; /* current time */
+} CheckHead; /* checkpoint header */
+
+typedef struct {
+    int mid; /* material type */
+    int ref; /* geometry identifier of the owner of a shared mesh, 0 if owned */
+    int vertN; /* number of vertices */
+    int edgeN; /* number of edges */
+    int faceN; /* number of faces */
+    Real r; /* bounding sphere radius */
+    RealVec O; /* centroid */
+    Real V[DIMTK][DIMS]; /* translational velocity */
+    Real W[DIMTK][DIMS]; /* rotational velocity */
+    Real at[DIMTK][DIMS]; /* translational acceleration */
+    RealVec g; /* gravitational acceleration */
+    Real ar[DIMTK][DIMS]; /* rotational acceleration */
+    RealVec Fp; /* pressure force */
+    RealVec Fv; /* viscous force */
+    RealVec Tt; /* total torque */
+    Real to; /* time to end power */
+    Real rho; /* density */
+    Real T; /* wall temperature */
+    Real cf; /* roughness */
+    Real area; /* area */
+    Real volume; /* volume */
+    Real R[DIMS][DIMS]; /* rotation from reference frame of mesh to current frame */
+    RealVec D; /* translation from reference frame of mesh to current frame */
+} CheckPoly; /* kinematic state of a polyhedron */
+
+typedef struct {
+    const char *fname; /* file name */
+    const char *data; /* mapped content */
+    size_t size; /* size of content without the checksum */
+    size_t pos; /* reading position */
+} CheckMap; /* memory mapped checkpoint */
+/****************************************************************************
+ * Static Function Declarations
+ ****************************************************************************/
+static void PackPoly(const Polyhedron *, CheckPoly *);
+static void UnpackPoly(const CheckPoly *, Polyhedron *);
+static void WriteBlock(const void *, const size_t, FILE *, uint64_t *);
+static void ReadBlock(void *, const size_t, CheckMap *);
+static uint64_t HashBlock(uint64_t, const void *, const size_t);
+/****************************************************************************
+ * Global Variables Definition with Private Scope
+ ****************************************************************************/
+static const char magic[8] = {'A', 'R', 'T', 'R', 'A', 'C', 'F', 'D'};
+static const uint64_t seed = UINT64_C(0xcbf29ce484222325); /* FNV offset basis */
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+/*
+ * Each block is written by a single sequential write and padded to the
+ * checksum word. Owned meshes follow the state of their polyhedron, so an
+ * instance always finds the mesh of its owner already read.
+ */
+void WriteCheckpoint(const Time *time, const Space *space)
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
+    const Polyhedron *poly = NULL;
+    const size_t nodeN = (size_t)part->n[X] * part->n[Y] * part->n[Z];
+    String fname = {'\0'};
+    snprintf(fname, sizeof fname, "checkpoint%05d.bin", time->dataC);
+    FILE *fp = Fopen(fname, "wb");
+    uint64_t sum = seed;
+    CheckHead head;
+    memset(&head, 0, sizeof head); /* padding bytes are part of the checksum */
+    memcpy(head.magic, magic, sizeof magic);
+    head.order = CKORDER;
+    head.version = CKVERSION;
+    head.intSize = sizeof(int);
+    head.realSize = sizeof(Real);
+    head.dimU = DIMU;
+    for (int s = 0; s < DIMS; ++s) {
+        head.n[s] = part->n[s];
+    }
+    head.totN = geo->totN;
+    head.sphN = geo->sphN;
+    head.stepC = time->stepC;
+    head.dataC = time->dataC;
+    head.now = time->now;
+    WriteBlock(&head, sizeof head, fp, &sum);
+    for (int n = 0; n < DIMU; ++n) {
+        WriteBlock(field->U[TO][n], nodeN * sizeof(Real), fp, &sum);
+    }
+    CheckPoly state;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        memset(&state, 0, sizeof state);
+        PackPoly(poly, &state);
+        WriteBlock(&state, sizeof state, fp, &sum);
+        if ((geo->sphN > n) || (0 != poly->ref)) {
+            continue;
+        }
+        WriteBlock(poly->v, poly->vertN * sizeof(*poly->v), fp, &sum);
+        WriteBlock(poly->f, poly->faceN * sizeof(*poly->f), fp, &sum);
+    }
+    fwrite(&sum, sizeof sum, 1, fp);
+    if (ferror(fp) || (0 != fclose(fp))) {
+        ShowError("failed to write checkpoint: %s", fname);
+    }
+    return;
+}
+/*
+ * The restart tag only names the file, the counts are taken from its header.
+ * The leading fixed-width fields of the header are checked first, so that
+ * files of a foreign byte order or data sizes are reported as such rather
+ * than as corrupted. Then the file is verified by its checksum as a whole
+ * before any data are taken. Node flags and the other time levels are
+ * initialized as the restart from visualization data does.
+ */
+void ReadCheckpoint(Time *time, Space *space)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    Geometry *const geo = &(space->geo);
+    Polyhedron *poly = NULL;
+    const size_t nodeN = (size_t)part->n[X] * part->n[Y] * part->n[Z];
+    String fname = {'\0'};
+    snprintf(fname, sizeof fname, "checkpoint%05d.bin", time->dataC);
+    struct stat st;
+    const int fd = open(fname, O_RDONLY);
+    if ((0 > fd) || (0 != fstat(fd, &st))) {
+        ShowError("failed to open checkpoint: %s", fname);
+    }
+    uint64_t sum = 0;
+    CheckMap map = {.fname = fname, .data = NULL, .size = (size_t)st.st_size, .pos = 0};
+    if (sizeof(CheckHead) + sizeof sum > map.size) {
+        ShowError("truncated checkpoint: %s", fname);
+    }
+    void *addr = mmap(NULL, map.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == addr) {
+        ShowError("failed to map checkpoint: %s", fname);
+    }
+    posix_madvise(addr, map.size, POSIX_MADV_SEQUENTIAL);
+    map.data = addr;
+    map.size = map.size - sizeof sum;
+    CheckHead head;
+    memcpy(&head, map.data, sizeof head);
+    if (0 != memcmp(head.magic, magic, sizeof magic)) {
+        ShowError("not a checkpoint file: %s", fname);
+    }
+    if (CKORDERSWAP == head.order) {
+        ShowError("checkpoint written with a foreign byte order: %s", fname);
+    }
+    if ((CKORDER != head.order) || (CKVERSION != head.version)) {
+        ShowError("unsupported checkpoint layout: %s", fname);
+    }
+    if ((sizeof(int) != head.intSize) || (sizeof(Real) != head.realSize)) {
+        ShowError("checkpoint written with int of %u and real of %u bytes: %s",
+                (unsigned)head.intSize, (unsigned)head.realSize, fname);
+    }
+    memcpy(&sum, map.data + map.size, sizeof sum);
+    if (HashBlock(seed, map.data, map.size) != sum) {
+        ShowError("checksum mismatch: %s", fname);
+    }
+    ReadBlock(&head, sizeof head, &map);
+    if ((DIMU != head.dimU) ||
+            (part->n[X] != head.n[X]) || (part->n[Y] != head.n[Y]) || (part->n[Z] != head.n[Z]) ||
+            (geo->totN != head.totN) || (geo->sphN != head.sphN)) {
+        ShowError("checkpoint does not match the case: %s", fname);
+    }
+    time->stepC = head.stepC;
+    time->dataC = head.dataC;
+    time->now = head.now;
+    /* field data */
+    int idx = 0; /* linear array index math variable */
+    for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
+        for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
+            for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                field->did[idx] = NONE;
+                field->fid[idx] = NONE;
+                field->lid[idx] = NONE;
+                field->gst[idx] = NONE;
+                if (InPartBox(k, j, i, part->ns[PIN])) {
+                    field->did[idx] = 0;
+                    field->fid[idx] = 0;
+                    field->lid[idx] = 0;
+                    field->gst[idx] = 0;
+                }
+            }
+        }
+    }
+    for (int tn = 0; tn < field->tl; ++tn) {
+        if (TO == tn) {
+            continue;
+        }
+        for (int n = 0; n < DIMU; ++n) {
+            memset(field->U[tn][n], 1, nodeN * sizeof(Real));
+        }
+    }
+    for (int n = 0; n < DIMU; ++n) {
+        ReadBlock(field->U[TO][n], nodeN * sizeof(Real), &map);
+    }
+    /* geometry data */
+    CheckPoly state;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        ReadBlock(&state, sizeof state, &map);
+        if (geo->sphN > n) {
+            UnpackPoly(&state, poly);
+            poly->faceN = 0; /* analytical polyhedron tag */
+            poly->facet = NULL;
+            continue;
+        }
+        if (0 != state.ref) {
+            if ((geo->sphN >= state.ref) || (n < state.ref) || (0 != geo->poly[state.ref - 1].ref)) {
+                ShowError("corrupted mesh owner in checkpoint: %s", fname);
+            }
+            SharePolyhedronMesh(state.ref, geo->poly + state.ref - 1, poly);
+            UnpackPoly(&state, poly);
+            continue;
+        }
+        poly->vertN = state.vertN;
+        poly->edgeN = state.edgeN;
+        poly->faceN = state.faceN;
+        AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
+        UnpackPoly(&state, poly);
+        ReadBlock(poly->v, poly->vertN * sizeof(*poly->v), &map);
+        ReadBlock(poly->f, poly->faceN * sizeof(*poly->f), &map);
+        BuildEdgeList(poly);
+    }
+    munmap(addr, map.size + sizeof sum);
+    return;
+}
+static void PackPoly(const Polyhedron *poly, CheckPoly *state)
+{
+    state->mid = poly->mid;
+    state->ref = poly->ref;
+    state->vertN = poly->vertN;
+    state->edgeN = poly->edgeN;
+    state->faceN = poly->faceN;
+    state->r = poly->r;
+    memcpy(state->O, poly->O, sizeof state->O);
+    memcpy(state->V, poly->V, sizeof state->V);
+    memcpy(state->W, poly->W, sizeof state->W);
+    memcpy(state->at, poly->at, sizeof state->at);
+    memcpy(state->g, poly->g, sizeof state->g);
+    memcpy(state->ar, poly->ar, sizeof state->ar);
+    memcpy(state->Fp, poly->Fp, sizeof state->Fp);
+    memcpy(state->Fv, poly->Fv, sizeof state->Fv);
+    memcpy(state->Tt, poly->Tt, sizeof state->Tt);
+    state->to = poly->to;
+    state->rho = poly->rho;
+    state->T = poly->T;
+    state->cf = poly->cf;
+    state->area = poly->area;
+    state->volume = poly->volume;
+    memcpy(state->R, poly->R, sizeof state->R);
+    memcpy(state->D, poly->D, sizeof state->D);
+    return;
+}
+static void UnpackPoly(const CheckPoly *state, Polyhedron *poly)
+{
+    poly->mid = state->mid;
+    poly->r = state->r;
+    memcpy(poly->O, state->O, sizeof state->O);
+    memcpy(poly->V, state->V, sizeof state->V);
+    memcpy(poly->W, state->W, sizeof state->W);
+    memcpy(poly->at, state->at, sizeof state->at);
+    memcpy(poly->g, state->g, sizeof state->g);
+    memcpy(poly->ar, state->ar, sizeof state->ar);
+    memcpy(poly->Fp, state->Fp, sizeof state->Fp);
+    memcpy(poly->Fv, state->Fv, sizeof state->Fv);
+    memcpy(poly->Tt, state->Tt, sizeof state->Tt);
+    poly->to = state->to;
+    poly->rho = state->rho;
+    poly->T = state->T;
+    poly->cf = state->cf;
+    poly->area = state->area;
+    poly->volume = state->volume;
+    memcpy(poly->R, state->R, sizeof state->R);
+    memcpy(poly->D, state->D, sizeof state->D);
+    return;
+}
+static void WriteBlock(const void *data, const size_t size, FILE *fp, uint64_t *sum)
+{
+    const char pad[CKALIGN] = {'\0'};
+    fwrite(data, sizeof(char), size, fp);
+    fwrite(pad, sizeof(char), (CKALIGN - size % CKALIGN) % CKALIGN, fp);
+    *sum = HashBlock(*sum, data, size);
+    return;
+}
+static void ReadBlock(void *data, const size_t size, CheckMap *map)
+{
+    const size_t span = size + (CKALIGN - size % CKALIGN) % CKALIGN;
+    if (map->size - map->pos < span) {
+        ShowError("truncated checkpoint: %s", map->fname);
+    }
+    memcpy(data, map->data + map->pos, size);
+    map->pos = map->pos + span;
+    return;
+}
+/*
+ * FNV-1a hash taken over 64-bit words, a trailing partial word is padded
+ * by zeros. Blocks are padded to whole words in the file, thus the hash of
+ * the whole content agrees with hashing the blocks in sequence.
+ */
+static uint64_t HashBlock(uint64_t h, const void *data, const size_t size)
+{
+    const uint64_t prime = UINT64_C(0x100000001b3);
+    const char *byte = data;
+    uint64_t word = 0;
+    size_t n = 0;
+    for (n = 0; n + sizeof word <= size; n = n + sizeof word) {
+        memcpy(&word, byte + n, sizeof word);
+        h = (h ^ word) * prime;
+    }
+    if (n < size) {
+        word = 0;
+        memcpy(&word, byte + n, size - n);
+        h = (h ^ word) * prime;
+    }
+    return h;
+}
+/* a good practice: end file with a newline */
+
@@ -0,0 +1,44 @@
+/****************************************************************************
+ *                              ArtraCFD                                    *
+ *                          <By Huangrui Mo>                                *
+ * Copyright (C) Huangrui Mo <huangrui.mo@gmail.com>                        *
+ * This file is part of ArtraCFD.                                           *
+ * ArtraCFD is free software: you can redistribute it and/or modify it      *
+ * under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or        *
+ * (at your option) any later version.                                      *
+ ****************************************************************************/
+/****************************************************************************
+ * Header File Guards to Avoid Interdependence
+ ****************************************************************************/
+#ifndef ARTRACFD_CHECKPOINT_H_ /* if undefined */
+#define ARTRACFD_CHECKPOINT_H_ /* set a unique marker */
+/****************************************************************************
+ * Required Header Files
+ ****************************************************************************/
+#include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+/****************************************************************************
+ * Public Functions Declaration
+ ****************************************************************************/
+/*
+ * Native checkpoint
+ *
+ * Function
+ *      Write and read the restart state in the native binary layout of the
+ *      machine: time counters, the conservative variables of all nodes at
+ *      the current time level, the kinematic state and pose of polyhedrons,
+ *      and the reference meshes of triangulated polyhedrons that own one.
+ *      Data are stored in full precision, hence restarts are bit-exact.
+ *      The header records the byte order and the sizes of int and Real, and
+ *      the file ends with a checksum of its content, which are verified
+ *      before the data are accepted. Reading takes the counts from the
+ *      header, the restart tag only selects the file.
+ */
+extern void WriteCheckpoint(const Time *, const Space *);
+extern void ReadCheckpoint(Time *, Space *);
+#endif
+/* a good practice: end file with a newline */
+
@@ -49,14 +49,19 @@ typedef enum {
     /* dimensions related to field variables */
     DIMU = 5, /* conservative vector: rho, rho_u, rho_v, rho_w, rho_eT */
     DIMUo = 6, /* primitive vector: rho, u, v, w, [p, hT, h], [T, c] */
+    DIMUc = 6, /* cached primitive vector: rho, u, v, w, p, T */
     /* parameters related to numerical model */
     PATHN = 30, /* neighbour searching path */
     PATHSEP = 4, /* layer separator in neighbour searching path: pathN, l1N, l2N, l3N */
     NONE = -1, /* invalid flag */
+    RKTWO = 0, /* 2nd order Runge-Kutta */
+    RKTHREE = 1, /* 3rd order Runge-Kutta */
+    RKTHREELS = 2, /* 3rd order low-storage Runge-Kutta */
     WENOTHREE = 0, /* 3rd order weno */
     WENOFIVE = 1, /* 5th order weno */
     OPTSPLIT = 0, /* operator splitting approximation */
     OPTBYOPT = 1, /* operator-by-operator approximation */
+    OPTSTRANG = 2, /* operator splitting with sweep order alternating by step */
     /* parameters related to domain partitions */
     NPART = 15, /* inner region, [west, east, south, north, front, back] x [Boundary, Ghost], physical region, all region */
     PIO = 0, /* the partition region for data iostream */
@@ -99,6 +104,8 @@ typedef enum {
     DIMTK = 2, /* number of time levels to store kinematic data */
     POLYN = 3, /* polygon facet type */
     EVF = 4, /* edge-vertex-face type */
+    BVHLEAF = 4, /* maximum number of faces in a bounding volume hierarchy leaf */
+    BVHSTACK = 64, /* traversal stack size of bounding volume hierarchy */
     /* parameters related to data probes */
     NPROBE = 5, /* point, line, curve, force, space probe */
     PROPT = 0,
@@ -126,12 +133,18 @@ extern const Real PI;
  * Member structures
  */
 typedef struct {
-    int did; /* domain identifier */
-    int fid; /* closest face identifier */
-    int lid; /* interfacial layer identifier */
-    int gst; /* ghost layer identifier */
-    Real U[DIMT][DIMU]; /* field data at each time level */
-} Node; /* field data */
+    int *restrict did; /* domain identifier */
+    int *restrict fid; /* closest face identifier */
+    int *restrict lid; /* interfacial layer identifier */
+    int *restrict gst; /* ghost layer identifier */
+    Real *U[DIMT][DIMU]; /* field data of each variable at each time level */
+    int tl; /* number of time levels stored by the temporal scheme */
+    Real *Uc[DIMUc]; /* primitive cache of a time level, NULL if disabled */
+    int tc; /* time level held by the primitive cache, NONE if outdated */
+    RealVec vmax; /* maximum characteristic speeds of fluid nodes */
+    int tv; /* time level of the maximum characteristic speeds, NONE if outdated */
+    void *store; /* storage block holding all the field arrays */
+} Field; /* field data with a separate array for each quantity */
 
 typedef struct {
     IntVec m; /* mesh number of spatial dimensions */
@@ -165,9 +178,43 @@ typedef struct {
     RealVec v2; /* vertex */
 } Facet; /* polyhedron facet */
 
+typedef struct {
+    Real box[DIMS][LIMIT]; /* axis-aligned bounding box */
+    int child; /* index of the first child, the second is next to it. NONE for leaf */
+    int fm; /* start of the face range in face order list */
+    int fn; /* end of the face range in face order list */
+} BvhNode; /* bounding volume hierarchy node */
+
+typedef struct {
+    int idx; /* linear array index of ghost node */
+    IntVec nG; /* ghost node */
+    IntVec nI; /* image node */
+    RealVec pG; /* ghost point */
+    RealVec pO; /* boundary point */
+    RealVec pI; /* image point */
+    RealVec N; /* normal at boundary point */
+    int sm; /* start of interpolation stencil */
+    int sn; /* end of interpolation stencil */
+} Ghost; /* ghost node with cached geometric data */
+
+typedef struct {
+    int n; /* number of stencil nodes */
+    int m; /* capacity of stencil */
+    int *restrict idx; /* linear array index of stencil nodes */
+    Real *restrict w; /* inverse distance weights of stencil nodes */
+} Stencil; /* interpolation stencils */
+
+typedef struct {
+    IntVec n; /* number of samples in each direction */
+    Real h; /* sample spacing */
+    RealVec s0; /* the first sample in reference frame */
+    Real *restrict d; /* signed distance of samples, negative inside */
+    int *restrict fid; /* closest face of samples */
+} DistField; /* signed distance field sampled in reference frame */
+
 typedef struct {
     int gid; /* geometry identifier */
-    IntVec N; /* line of impact */
+    RealVec N; /* line of impact */
 } Collision; /* collision list */
 
 typedef struct {
@@ -194,6 +241,13 @@ typedef struct {
     Real area; /* area */
     Real volume; /* volume */
     Real box[DIMS][LIMIT]; /* a bounding box of the polyhedron */
+    int nbox[DIMS][LIMIT]; /* bounding box in node space at the last mapping */
+    int ref; /* geometry identifier of the owner of a shared mesh, 0 if owned */
+    Real R[DIMS][DIMS]; /* rotation from reference frame of mesh to current frame */
+    RealVec D; /* translation from reference frame of mesh to current frame */
+    RealVec Oo; /* centroid in reference frame */
+    Real Io[DIMS][DIMS]; /* inertia matrix in reference frame */
+    Real bo[DIMS][LIMIT]; /* bounding box in reference frame */
     int (*restrict f)[POLYN]; /* face-vertex list */
     Real (*restrict Nf)[DIMS]; /* face normal */
     int (*restrict e)[EVF]; /* edge-vertex-face list */
@@ -201,15 +255,42 @@ typedef struct {
     Real (*restrict v)[DIMS]; /* vertex list */
     Real (*restrict Nv)[DIMS]; /* vertex normal */
     Facet *facet; /* facet data */
+    int bvhN; /* number of nodes in bounding volume hierarchy */
+    BvhNode *bvh; /* bounding volume hierarchy of faces, root at 0 */
+    int *restrict fo; /* face order list referenced by hierarchy leaves */
+    DistField df; /* signed distance field of triangulated polyhedron */
+    int gs[PATHSEP]; /* end of each layer in ghost list, gs[0] = 0 */
+    int lidN[PATHSEP]; /* number of interfacial nodes of each layer */
+    int ghostM; /* capacity of ghost list */
+    Ghost *ghost; /* ghost nodes ordered by layer, then by node index */
+    Stencil sten; /* interpolation stencils of ghost nodes */
 } Polyhedron; /* polyhedron */
 
+typedef struct {
+    IntVec n; /* number of cells in each direction */
+    Real h; /* cell size */
+    RealVec s0; /* lower corner of cells */
+    int cellM; /* capacity of cell heads */
+    int itemM; /* capacity of cell entries */
+    int activeN; /* number of geometries in the indexed region */
+    int stamp; /* stamp of the latest query */
+    int *head; /* first entry of each cell, cells are stored consecutively */
+    int *item; /* geometry identifiers of cell entries */
+    int *active; /* geometries in the indexed region in ascending order */
+    int *mark; /* query stamp of each geometry */
+} CellList; /* uniform grid cell list of geometries */
+
 typedef struct {
     int totN; /* total number of geometries */
     int sphN; /* number of analytical polyhedrons */
     int stlN; /* number of triangulated polyhedrons */
     int colN; /* colliding list pointer and count */
+    Real weld; /* vertex weld tolerance of triangulated polyhedrons */
+    int dfN; /* distance field samples along the longest side, 0 if off */
     Polyhedron *poly; /* geometry list */
     Collision *col; /* collision list */
+    int *slot; /* collision list entry of each geometry identifier */
+    CellList cl; /* cell list of bounding boxes */
 } Geometry; /* geometry data */
 
 typedef struct {
@@ -221,7 +302,7 @@ typedef struct {
  * Memory of pointer type members should be dynamically allocated from heap.
  */
 typedef struct {
-    Node *node; /* field data */
+    Field field; /* field data */
     Geometry geo; /* geometry data */
     Partition part; /* domain discretization and partition data */
 } Space;
@@ -233,6 +314,9 @@ typedef struct {
     int dataN[NPROBE]; /* number for each data probe type */
     int dataW[NPROBE]; /* writing frequency for each data probe type */
     int dataStreamer; /* data streamer */
+    int dataFormat; /* data encoding of structured data */
+    int restartFormat; /* restart data, 0: visualization data; 1: native checkpoint */
+    int dataQueue; /* staging buffers of asynchronous space data writing, 0 if synchronous */
     int dataC; /* data writing count */
     Real end; /* termination time */
     Real now; /* current time recorder */
@@ -254,6 +338,7 @@ typedef struct {
     int mid; /* material identifier */
     int gState; /* gravity state */
     int sState; /* source state */
+    int pCache; /* primitive cache state */
     Real refMa; /* reference Mach number */
     Real refMu; /* reference dynamic viscosity */
     Real gamma; /* heat capacity ratio */
@@ -19,35 +19,94 @@
 #include <float.h> /* size of floating point values */
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    int size; /* number of buckets, a power of two */
+    int weldN; /* number of vertices welded to a distinct vertex */
+    int *restrict head; /* first vertex of each bucket */
+    int *restrict next; /* next vertex of the same bucket */
+} VertexHash; /* vertex hash table with separate chaining */
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static int AddVertex(const Real [restrict], Polyhedron *);
+static int AddVertex(const Real [restrict], const Real, VertexHash *, Polyhedron *);
+static unsigned int HashVertex(const Real [restrict], const Real, const int [restrict]);
 static int FindEdge(const int, const int, const int, int [restrict][EVF]);
 static void ComputeParametersSphere(const int, Polyhedron *);
 static void ComputeParametersPolyhedron(const int, Polyhedron *);
-static void TransformVertex(const Real [restrict], const Real [restrict],
-        const Real [restrict][DIMS], const Real [restrict], Real [restrict][LIMIT],
+static void LinkMesh(const Polyhedron *, Polyhedron *);
+static void CopyMesh(Polyhedron *);
+static void ScaleVertex(const Real [restrict], const Real [restrict], Real [restrict][LIMIT],
         const int, Real [restrict][DIMS]);
-static void TransformNormal(const Real [restrict][DIMS], const int, Real [restrict][DIMS]);
-static Real TransformInertia(const Real [restrict], Real [restrict][DIMS]);
+static void ApplyPose(Polyhedron *);
+static void EncloseBox(Real [restrict][LIMIT], const Polyhedron *, Real [restrict][LIMIT]);
+static void MapReference(const Real [restrict], const Polyhedron *, Real [restrict]);
+static void BuildHierarchy(Polyhedron *);
+static void SplitHierarchy(const int, const int, const int, Real [restrict][DIMS], Polyhedron *);
+static void RefitHierarchy(Polyhedron *);
+static Real BoxDistance(const Real [restrict], const Real [restrict][LIMIT]);
+static int SearchClosestFace(const Real [restrict], const Polyhedron *);
+static int LocatePoint(const Real [restrict], const Polyhedron *, int [restrict]);
+static int CrossLine(const Real [restrict], const Real [restrict][DIMS], const Polyhedron *,
+        Real [restrict]);
+static Real EdgeFunction(const Real [restrict], const Real [restrict], const Real [restrict]);
+static Real IntersectFace(const Real [restrict], const int, const Polyhedron *,
+        Real [restrict], Real [restrict]);
+static void BuildDistanceField(const int, Polyhedron *);
+static int BoxOverlap(Real [restrict][LIMIT], Real [restrict][LIMIT]);
+static void CellRange(Real [restrict][LIMIT], const CellList *, int [restrict][LIMIT]);
+static int LocateSample(const Real [restrict], const Polyhedron *, Real [restrict]);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void ConvertPolyhedron(Polyhedron *poly)
+/*
+ * Vertices are deduplicated by a hash table in the order of their first
+ * appearance. By default, only vertices with identical coordinates are
+ * merged. When a positive weld tolerance is given, coordinates are hashed
+ * by cells of the tolerance size and a vertex is merged into the lowest
+ * indexed vertex within the tolerance in the neighbouring cells. Facets
+ * collapsed by merging are dropped. Edges are built afterwards from the
+ * face-vertex list by sorting.
+ */
+void ConvertPolyhedron(const Real weld, Polyhedron *poly)
 {
     /* allocate memory, assume over-estimated vertex and edge */
     AllocatePolyhedronMemory(POLYN * poly->faceN, POLYN * poly->faceN, poly->faceN, poly);
+    VertexHash hash = {1, 0, NULL, NULL};
+    while (hash.size < 2 * POLYN * poly->faceN) {
+        hash.size *= 2;
+    }
+    hash.head = AssignStorage(hash.size * sizeof(*hash.head));
+    hash.next = AssignStorage((POLYN * poly->faceN + 1) * sizeof(*hash.next));
+    for (int n = 0; n < hash.size; ++n) {
+        hash.head[n] = NONE;
+    }
     /* convert representation */
-    for (int n = 0; n < poly->faceN; ++n) {
-        poly->f[n][0] = AddVertex(poly->facet[n].v0, poly);
-        poly->f[n][1] = AddVertex(poly->facet[n].v1, poly);
-        poly->f[n][2] = AddVertex(poly->facet[n].v2, poly);
-        AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-        AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-        AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
-    }
-    QuickSortEdge(poly->edgeN, poly->e);
+    const int facetN = poly->faceN;
+    int *restrict f = NULL;
+    poly->faceN = 0;
+    for (int n = 0; n < facetN; ++n) {
+        f = poly->f[poly->faceN];
+        f[0] = AddVertex(poly->facet[n].v0, weld, &hash, poly);
+        f[1] = AddVertex(poly->facet[n].v1, weld, &hash, poly);
+        f[2] = AddVertex(poly->facet[n].v2, weld, &hash, poly);
+        if ((f[0] == f[1]) || (f[1] == f[2]) || (f[2] == f[0])) {
+            continue; /* drop collapsed facet */
+        }
+        ++(poly->faceN);
+    }
+    const int openN = BuildEdgeList(poly);
+    ShowInfo("  polyhedron import: %d facets, %d vertices, %d edges\n",
+            poly->faceN, poly->vertN, poly->edgeN);
+    ShowInfo("    welded vertices: %d, dropped facets: %d, edges not shared by two facets: %d\n",
+            hash.weldN, facetN - poly->faceN, openN);
+    if (0 < openN) {
+        ShowWarning("polyhedron surface is not closed and manifold");
+    }
+    RetrieveStorage(hash.head);
+    RetrieveStorage(hash.next);
     /* adjust the memory allocation */
     RetrieveStorage(poly->facet);
     poly->facet = NULL;
@@ -57,6 +116,10 @@ void ConvertPolyhedron(Polyhedron *poly)
     poly->Nv = realloc(poly->Nv, poly->vertN * sizeof(*poly->Nv));
     return;
 }
+/*
+ * A newly allocated mesh is owned by the polyhedron, and its reference
+ * frame coincides with the current frame.
+ */
 void AllocatePolyhedronMemory(const int vertN, const int edgeN,
         const int faceN, Polyhedron *poly)
 {
@@ -66,42 +129,197 @@ void AllocatePolyhedronMemory(const int vertN, const int edgeN,
     poly->Ne = AssignStorage(edgeN * sizeof(*poly->Ne));
     poly->v = AssignStorage(vertN * sizeof(*poly->v));
     poly->Nv = AssignStorage(vertN * sizeof(*poly->Nv));
+    poly->ref = 0;
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c < DIMS; ++c) {
+            poly->R[r][c] = (r == c) ? 1.0 : 0.0;
+        }
+        poly->D[r] = 0.0;
+    }
     return;
 }
-static int AddVertex(const Real v[restrict], Polyhedron *poly)
+/*
+ * Instances of a mesh share every array of the owner and keep their own
+ * pose. Mass properties in the reference frame are linked again after the
+ * owner computes them.
+ */
+void SharePolyhedronMesh(const int gid, const Polyhedron *owner, Polyhedron *poly)
 {
-    /* search the vertex list, if already exist, return the index */
-    for (int n = 0; n < poly->vertN; ++n) {
-        if ((v[X] == poly->v[n][X]) && (v[Y] == poly->v[n][Y]) &&
-                (v[Z] == poly->v[n][Z])) {
-            return n;
+    LinkMesh(owner, poly);
+    poly->ref = gid;
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c < DIMS; ++c) {
+            poly->R[r][c] = (r == c) ? 1.0 : 0.0;
+        }
+        poly->D[r] = 0.0;
+    }
+    return;
+}
+static void LinkMesh(const Polyhedron *owner, Polyhedron *poly)
+{
+    poly->faceN = owner->faceN;
+    poly->edgeN = owner->edgeN;
+    poly->vertN = owner->vertN;
+    poly->f = owner->f;
+    poly->Nf = owner->Nf;
+    poly->e = owner->e;
+    poly->Ne = owner->Ne;
+    poly->v = owner->v;
+    poly->Nv = owner->Nv;
+    poly->bvhN = owner->bvhN;
+    poly->bvh = owner->bvh;
+    poly->fo = owner->fo;
+    poly->df = owner->df;
+    poly->area = owner->area;
+    poly->volume = owner->volume;
+    poly->r = owner->r;
+    memcpy(poly->Oo, owner->Oo, sizeof(poly->Oo));
+    memcpy(poly->Io, owner->Io, sizeof(poly->Io));
+    memcpy(poly->bo, owner->bo, sizeof(poly->bo));
+    return;
+}
+/*
+ * Detach an instance from the shared mesh by a private copy of the mesh.
+ * The distance field is not copied since only rigid motion preserves it.
+ */
+static void CopyMesh(Polyhedron *poly)
+{
+    const Polyhedron owner = *poly;
+    poly->f = AssignStorage(poly->faceN * sizeof(*poly->f));
+    poly->Nf = AssignStorage(poly->faceN * sizeof(*poly->Nf));
+    poly->e = AssignStorage(poly->edgeN * sizeof(*poly->e));
+    poly->Ne = AssignStorage(poly->edgeN * sizeof(*poly->Ne));
+    poly->v = AssignStorage(poly->vertN * sizeof(*poly->v));
+    poly->Nv = AssignStorage(poly->vertN * sizeof(*poly->Nv));
+    memcpy(poly->f, owner.f, poly->faceN * sizeof(*poly->f));
+    memcpy(poly->Nf, owner.Nf, poly->faceN * sizeof(*poly->Nf));
+    memcpy(poly->e, owner.e, poly->edgeN * sizeof(*poly->e));
+    memcpy(poly->Ne, owner.Ne, poly->edgeN * sizeof(*poly->Ne));
+    memcpy(poly->v, owner.v, poly->vertN * sizeof(*poly->v));
+    memcpy(poly->Nv, owner.Nv, poly->vertN * sizeof(*poly->Nv));
+    if (NULL != owner.bvh) {
+        poly->bvh = AssignStorage(2 * poly->faceN * sizeof(*poly->bvh));
+        poly->fo = AssignStorage(poly->faceN * sizeof(*poly->fo));
+        memcpy(poly->bvh, owner.bvh, poly->bvhN * sizeof(*poly->bvh));
+        memcpy(poly->fo, owner.fo, poly->faceN * sizeof(*poly->fo));
+    }
+    poly->df.d = NULL;
+    poly->df.fid = NULL;
+    poly->ref = 0;
+    return;
+}
+static int AddVertex(const Real v[restrict], const Real weld, VertexHash *hash, Polyhedron *poly)
+{
+    /* search the buckets of the vertex, if already exist, return the index */
+    int m = NONE;
+    if (0 < weld) {
+        IntVec h = {0};
+        for (h[Z] = -1; h[Z] <= 1; ++h[Z]) {
+            for (h[Y] = -1; h[Y] <= 1; ++h[Y]) {
+                for (h[X] = -1; h[X] <= 1; ++h[X]) {
+                    for (int n = hash->head[HashVertex(v, weld, h) & (hash->size - 1)]; NONE != n; n = hash->next[n]) {
+                        if ((weld * weld >= Dist2(v, poly->v[n])) && ((NONE == m) || (m > n))) {
+                            m = n;
+                        }
+                    }
+                }
+            }
+        }
+        if (NONE != m) {
+            if ((v[X] != poly->v[m][X]) || (v[Y] != poly->v[m][Y]) || (v[Z] != poly->v[m][Z])) {
+                ++(hash->weldN);
+            }
+            return m;
+        }
+    }
+    const IntVec h = {0};
+    const unsigned int b = HashVertex(v, weld, h) & (hash->size - 1);
+    if (0 >= weld) {
+        for (int n = hash->head[b]; NONE != n; n = hash->next[n]) {
+            if ((v[X] == poly->v[n][X]) && (v[Y] == poly->v[n][Y]) &&
+                    (v[Z] == poly->v[n][Z])) {
+                return n;
+            }
         }
     }
     /* otherwise, add to the vertex list */
     poly->v[poly->vertN][X] = v[X];
     poly->v[poly->vertN][Y] = v[Y];
     poly->v[poly->vertN][Z] = v[Z];
+    hash->next[poly->vertN] = hash->head[b];
+    hash->head[b] = poly->vertN;
     ++(poly->vertN); /* increase pointer */
     return (poly->vertN - 1); /* return index */
 }
-void AddEdge(const int v0, const int v1, const int f, Polyhedron *poly)
+/*
+ * FNV-1a hash of the coordinates, or of the weld cell shifted by h when a
+ * positive weld tolerance is given. Negative zeros are hashed as zeros to
+ * agree with the comparison of coordinates.
+ */
+static unsigned int HashVertex(const Real v[restrict], const Real weld, const int h[restrict])
 {
-    /* insert by a predefined order */
-    const int vMax = (v0 > v1) ? v0 : v1;
-    const int vMin = (v0 > v1) ? v1 : v0;
-    /* search the edge list, if already exist, add the second face index */
-    for (int n = 0; n < poly->edgeN; ++n) {
-        if ((vMax == poly->e[n][0]) && (vMin == poly->e[n][1])) {
-            poly->e[n][3] = f;
-            return;
+    unsigned int key = 2166136261u;
+    const unsigned char *byte = NULL;
+    size_t size = 0;
+    for (int s = 0; s < DIMS; ++s) {
+        const Real x = v[s] + 0.0;
+        const long c = (0 < weld) ? (long)floor(v[s] / weld) + h[s] : 0;
+        if (0 < weld) {
+            byte = (const unsigned char *)&c;
+            size = sizeof(c);
+        } else {
+            byte = (const unsigned char *)&x;
+            size = sizeof(x);
+        }
+        for (size_t n = 0; n < size; ++n) {
+            key = (key ^ byte[n]) * 16777619u;
         }
     }
-    /* otherwise, add to the edge list */
-    poly->e[poly->edgeN][0] = vMax;
-    poly->e[poly->edgeN][1] = vMin;
-    poly->e[poly->edgeN][2] = f;
-    ++(poly->edgeN); /* increase pointer */
-    return;
+    return key;
+}
+/*
+ * Each face contributes its three edges. After sorting these half edges by
+ * the predefined vertex order, identical edges are adjacent, and each edge
+ * records its lowest and highest face index. This agrees with adding edges
+ * face by face and sets the edge list in the searching order.
+ */
+int BuildEdgeList(Polyhedron *poly)
+{
+    const int halfN = POLYN * poly->faceN;
+    int (*h)[EVF] = AssignStorage((halfN + 1) * sizeof(*h));
+    for (int n = 0; n < poly->faceN; ++n) {
+        for (int s = 0; s < POLYN; ++s) {
+            const int v0 = poly->f[n][s];
+            const int v1 = poly->f[n][(s + 1) % POLYN];
+            h[POLYN * n + s][0] = (v0 > v1) ? v0 : v1;
+            h[POLYN * n + s][1] = (v0 > v1) ? v1 : v0;
+            h[POLYN * n + s][2] = n;
+        }
+    }
+    QuickSortEdge(halfN, h);
+    int openN = 0; /* edges not shared by exactly two faces */
+    int l = 0;
+    poly->edgeN = 0;
+    for (int m = 0; m < halfN; m = l) {
+        int *restrict e = poly->e[poly->edgeN];
+        e[0] = h[m][0];
+        e[1] = h[m][1];
+        e[2] = h[m][2];
+        e[3] = h[m][2];
+        for (l = m + 1; (l < halfN) && (h[l][0] == e[0]) && (h[l][1] == e[1]); ++l) {
+            e[2] = (e[2] < h[l][2]) ? e[2] : h[l][2];
+            e[3] = (e[3] > h[l][2]) ? e[3] : h[l][2];
+        }
+        if (2 != l - m) {
+            ++openN;
+        }
+        if (1 == l - m) { /* a single face */
+            e[3] = 0;
+        }
+        ++(poly->edgeN);
+    }
+    RetrieveStorage(h);
+    return openN;
 }
 void QuickSortEdge(const int n, int e[restrict][EVF])
 {
@@ -159,6 +377,11 @@ static int FindEdge(const int v0, const int v1, const int n, int e[restrict][EVF
     ShowError("finding edge failed...");
     return -1;
 }
+/*
+ * Rigid motion only updates the pose, hence the mesh stays in its reference
+ * frame and may be shared by instances. Scaling changes the mesh itself and
+ * is applied in the reference frame, a shared mesh is copied beforehand.
+ */
 void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *poly)
 {
@@ -168,96 +391,150 @@ void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
         {Cos[Y]*Cos[Z], -Cos[X]*Sin[Z]+Sin[X]*Sin[Y]*Cos[Z], Sin[X]*Sin[Z]+Cos[X]*Sin[Y]*Cos[Z]},
         {Cos[Y]*Sin[Z], Cos[X]*Cos[Z]+Sin[X]*Sin[Y]*Sin[Z], -Sin[X]*Cos[Z]+Cos[X]*Sin[Y]*Sin[Z]},
         {-Sin[Y], Sin[X]*Cos[Y], Cos[X]*Cos[Y]}};
-    const Real invrot[DIMS][DIMS] = { /* inverse rotation matrix */
-        {rotate[0][0], rotate[1][0], rotate[2][0]},
-        {rotate[0][1], rotate[1][1], rotate[2][1]},
-        {rotate[0][2], rotate[1][2], rotate[2][2]}};
-    const Real num = 1.0 / sqrt(2.0);
-    const Real axe[6][DIMS] = { /* direction vector of axis xx, yy, zz, xy, yz, zx */
-        {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0},
-        {num, num, 0.0}, {0.0, num, num}, {num, 0.0, num}};
-    RealVec axis = {0.0}; /* direction vector of axis in rotated frame */
-    Real I[6] = {0.0}; /* inertia tensor after rotation */
-    /* transforming vertex and build the new bounding box */
-    for (int s = 0; s < DIMS; ++s) {
-        poly->box[s][MIN] = FLT_MAX;
-        poly->box[s][MAX] = FLT_MIN;
-    }
-    TransformVertex(O, scale, rotate, offset, poly->box, poly->vertN, poly->v);
-    /* transforming normal assuming pure rotation and translation */
-    TransformNormal(rotate, poly->faceN, poly->Nf);
-    TransformNormal(rotate, poly->edgeN, poly->Ne);
-    TransformNormal(rotate, poly->vertN, poly->Nv);
-    /* transform inertial tensor */
-    for (int n = 0; n < 6; ++n) {
-        axis[X] = Dot(invrot[X], axe[n]);
-        axis[Y] = Dot(invrot[Y], axe[n]);
-        axis[Z] = Dot(invrot[Z], axe[n]);
-        I[n] = TransformInertia(axis, poly->I);
-    }
-    poly->I[X][X] = I[0];  poly->I[X][Y] = -I[3]; poly->I[X][Z] = -I[5];
-    poly->I[Y][X] = -I[3]; poly->I[Y][Y] = I[1];  poly->I[Y][Z] = -I[4];
-    poly->I[Z][X] = -I[5]; poly->I[Z][Y] = -I[4]; poly->I[Z][Z] = I[2];
-    /* centroid should be transformed at last */
-    Real Oc[1][DIMS] = {{poly->O[X], poly->O[Y], poly->O[Z]}};
-    TransformVertex(O, scale, rotate, offset, poly->box, 1, Oc);
-    poly->O[X] = Oc[0][X];
-    poly->O[Y] = Oc[0][Y];
-    poly->O[Z] = Oc[0][Z];
+    const RealVec Oc = {O[X], O[Y], O[Z]}; /* O may alias the centroid */
+    if ((1.0 != scale[X]) || (1.0 != scale[Y]) || (1.0 != scale[Z])) {
+        if (0 != poly->ref) {
+            CopyMesh(poly);
+        }
+        /* a distance field follows rigid motion only */
+        RetrieveStorage(poly->df.d);
+        RetrieveStorage(poly->df.fid);
+        poly->df.d = NULL;
+        poly->df.fid = NULL;
+        RealVec Or = {0.0}; /* scaling center in reference frame */
+        MapReference(Oc, poly, Or);
+        for (int s = 0; s < DIMS; ++s) {
+            poly->bo[s][MIN] = FLT_MAX;
+            poly->bo[s][MAX] = -FLT_MAX;
+        }
+        ScaleVertex(Or, scale, poly->bo, poly->vertN, poly->v);
+        Real Oo[1][DIMS] = {{poly->Oo[X], poly->Oo[Y], poly->Oo[Z]}};
+        Real box[DIMS][LIMIT] = {{0.0}};
+        ScaleVertex(Or, scale, box, 1, Oo);
+        memcpy(poly->Oo, Oo[0], sizeof(poly->Oo));
+        /* hierarchy topology is invariant, only boxes need to follow vertices */
+        if (NULL != poly->bvh) {
+            RefitHierarchy(poly);
+        }
+    }
+    /* compose rotation about O and translation with the current pose */
+    Real R[DIMS][DIMS] = {{0.0}};
+    RealVec D = {0.0};
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c < DIMS; ++c) {
+            R[r][c] = rotate[r][X] * poly->R[X][c] + rotate[r][Y] * poly->R[Y][c] +
+                rotate[r][Z] * poly->R[Z][c];
+        }
+        D[r] = rotate[r][X] * (poly->D[X] - Oc[X]) + rotate[r][Y] * (poly->D[Y] - Oc[Y]) +
+            rotate[r][Z] * (poly->D[Z] - Oc[Z]) + Oc[r] + offset[r];
+    }
+    memcpy(poly->R, R, sizeof(R));
+    memcpy(poly->D, D, sizeof(D));
+    ApplyPose(poly);
     return;
 }
-static void TransformVertex(const Real O[restrict], const Real scale[restrict],
-        const Real rotate[restrict][DIMS], const Real offset[restrict],
+static void ScaleVertex(const Real O[restrict], const Real scale[restrict],
         Real box[restrict][LIMIT], const int vertN, Real v[restrict][DIMS])
 {
-    RealVec tmp = {0.0};
     for (int n = 0; n < vertN; ++n) {
-        /* translate reference frame to a parallel frame at the reference point */
-        v[n][X] = v[n][X] - O[X];
-        v[n][Y] = v[n][Y] - O[Y];
-        v[n][Z] = v[n][Z] - O[Z];
-        /* scale */
-        v[n][X] = v[n][X] * scale[X];
-        v[n][Y] = v[n][Y] * scale[Y];
-        v[n][Z] = v[n][Z] * scale[Z];
-        /* rotate */
-        tmp[X] = v[n][X];
-        tmp[Y] = v[n][Y];
-        tmp[Z] = v[n][Z];
-        v[n][X] = Dot(rotate[X], tmp);
-        v[n][Y] = Dot(rotate[Y], tmp);
-        v[n][Z] = Dot(rotate[Z], tmp);
-        /* translate with offset and then translate reference back to origin */
-        v[n][X] = v[n][X] + offset[X] + O[X];
-        v[n][Y] = v[n][Y] + offset[Y] + O[Y];
-        v[n][Z] = v[n][Z] + offset[Z] + O[Z];
         for (int s = 0; s < DIMS; ++s) {
+            v[n][s] = (v[n][s] - O[s]) * scale[s] + O[s];
             box[s][MIN] = (box[s][MIN] < v[n][s]) ? box[s][MIN] : v[n][s];
             box[s][MAX] = (box[s][MAX] > v[n][s]) ? box[s][MAX] : v[n][s];
         }
     }
     return;
 }
-static void TransformNormal(const Real matrix[restrict][DIMS],
-        const int normalN, Real N[restrict][DIMS])
+/*
+ * Centroid, inertia, and bounding box in the current frame follow from the
+ * reference frame by the pose. The bounding box encloses the corners of the
+ * reference bounding box, which is exact for an identity pose. Once the
+ * hierarchy exists, it is further clipped to the box enclosing the corners
+ * of the hierarchy nodes at the second level, which stays tight for rotated
+ * elongated bodies at a fixed cost per pose.
+ */
+static void ApplyPose(Polyhedron *poly)
+{
+    Real RI[DIMS][DIMS] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        poly->O[s] = Dot(poly->R[s], poly->Oo) + poly->D[s];
+        for (int c = 0; c < DIMS; ++c) {
+            RI[s][c] = poly->R[s][X] * poly->Io[X][c] + poly->R[s][Y] * poly->Io[Y][c] +
+                poly->R[s][Z] * poly->Io[Z][c];
+        }
+    }
+    for (int r = 0; r < DIMS; ++r) {
+        for (int c = 0; c < DIMS; ++c) {
+            poly->I[r][c] = RI[r][X] * poly->R[c][X] + RI[r][Y] * poly->R[c][Y] + RI[r][Z] * poly->R[c][Z];
+        }
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        poly->box[s][MIN] = FLT_MAX;
+        poly->box[s][MAX] = -FLT_MAX;
+    }
+    EncloseBox(poly->bo, poly, poly->box);
+    if (NULL == poly->bvh) {
+        return;
+    }
+    int node[4] = {0}; /* hierarchy nodes down to the second level */
+    int nodeN = 1;
+    for (int l = 0; l < 2; ++l) {
+        for (int n = nodeN - 1; n >= 0; --n) {
+            const int child = poly->bvh[node[n]].child;
+            if (NONE != child) {
+                node[n] = child;
+                node[nodeN] = child + 1;
+                ++nodeN;
+            }
+        }
+    }
+    Real box[DIMS][LIMIT] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = FLT_MAX;
+        box[s][MAX] = -FLT_MAX;
+    }
+    for (int n = 0; n < nodeN; ++n) {
+        EncloseBox(poly->bvh[node[n]].box, poly, box);
+    }
+    for (int s = 0; s < DIMS; ++s) {
+        poly->box[s][MIN] = (poly->box[s][MIN] > box[s][MIN]) ? poly->box[s][MIN] : box[s][MIN];
+        poly->box[s][MAX] = (poly->box[s][MAX] < box[s][MAX]) ? poly->box[s][MAX] : box[s][MAX];
+    }
+    return;
+}
+/*
+ * Extend a box in the current frame to enclose the corners of a box in the
+ * reference frame mapped by the pose.
+ */
+static void EncloseBox(Real bo[restrict][LIMIT], const Polyhedron *poly, Real box[restrict][LIMIT])
 {
-    RealVec tmp = {0.0};
-    for (int n = 0; n < normalN; ++n) {
-        tmp[X] = N[n][X];
-        tmp[Y] = N[n][Y];
-        tmp[Z] = N[n][Z];
-        N[n][X] = Dot(matrix[X], tmp);
-        N[n][Y] = Dot(matrix[Y], tmp);
-        N[n][Z] = Dot(matrix[Z], tmp);
-        /* normalization is needed if anisotropic transformation happens */
+    RealVec corner = {0.0};
+    for (int n = 0; n < 8; ++n) {
+        corner[X] = bo[X][n % 2];
+        corner[Y] = bo[Y][(n / 2) % 2];
+        corner[Z] = bo[Z][n / 4];
+        for (int s = 0; s < DIMS; ++s) {
+            const Real x = Dot(poly->R[s], corner) + poly->D[s];
+            box[s][MIN] = (box[s][MIN] < x) ? box[s][MIN] : x;
+            box[s][MAX] = (box[s][MAX] > x) ? box[s][MAX] : x;
+        }
     }
     return;
 }
-static Real TransformInertia(const Real axis[restrict], Real I[restrict][DIMS])
+static void MapReference(const Real p[restrict], const Polyhedron *poly, Real q[restrict])
 {
-    return I[X][X] * axis[X] * axis[X] + I[Y][Y] * axis[Y] * axis[Y] +
-        I[Z][Z] * axis[Z] * axis[Z] + 2.0 * I[X][Y] * axis[X] * axis[Y] +
-        2.0 * I[Y][Z] * axis[Y] * axis[Z] + 2.0 * I[Z][X] * axis[Z] * axis[X];
+    const RealVec dp = {p[X] - poly->D[X], p[Y] - poly->D[Y], p[Z] - poly->D[Z]};
+    for (int s = 0; s < DIMS; ++s) {
+        q[s] = poly->R[X][s] * dp[X] + poly->R[Y][s] * dp[Y] + poly->R[Z][s] * dp[Z];
+    }
+    return;
+}
+void MapVertex(const int vid, const Polyhedron *poly, Real v[restrict])
+{
+    for (int s = 0; s < DIMS; ++s) {
+        v[s] = Dot(poly->R[s], poly->v[vid]) + poly->D[s];
+    }
+    return;
 }
 void ComputeGeometryParameters(const int collapse, Geometry *const geo)
 {
@@ -265,7 +542,19 @@ void ComputeGeometryParameters(const int collapse, Geometry *const geo)
         ComputeParametersSphere(collapse, geo->poly + n);
     }
     for (int n = geo->sphN; n < geo->totN; ++n) {
+        if (0 != geo->poly[n].ref) {
+            continue;
+        }
         ComputeParametersPolyhedron(collapse, geo->poly + n);
+        if (0 < geo->dfN) {
+            BuildDistanceField(geo->dfN, geo->poly + n);
+        }
+    }
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        if (0 != geo->poly[n].ref) {
+            LinkMesh(geo->poly + geo->poly[n].ref - 1, geo->poly + n);
+        }
+        ApplyPose(geo->poly + n);
     }
     return;
 }
@@ -302,6 +591,10 @@ static void ComputeParametersSphere(const int collapse, Polyhedron *poly)
     poly->I[Z][X] = 0.0;  poly->I[Z][Y] = 0.0;  poly->I[Z][Z] = num;
     return;
 }
+/*
+ * Mass properties and normals are computed in the reference frame of the
+ * mesh, and the pose maps them into the current frame.
+ */
 static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
 {
     /* initialize parameters */
@@ -414,24 +707,24 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         poly->area = area - 2.0 * volume; /* change to side area of a unit thickness polygon */
     }
     poly->volume = volume;
-    poly->O[X] = O[X];
-    poly->O[Y] = O[Y];
-    poly->O[Z] = O[Z];
+    poly->Oo[X] = O[X];
+    poly->Oo[Y] = O[Y];
+    poly->Oo[Z] = O[Z];
     /* inertia relative to centroid */
-    poly->I[X][X] = I[1] + I[2] - volume * (O[Y] * O[Y] + O[Z] * O[Z]);
-    poly->I[X][Y] = -I[3] + volume * O[X] * O[Y];
-    poly->I[X][Z] = -I[5] + volume * O[Z] * O[X];
-    poly->I[Y][X] = poly->I[X][Y];
-    poly->I[Y][Y] = I[0] + I[2] - volume * (O[Z] * O[Z] + O[X] * O[X]);
-    poly->I[Y][Z] = -I[4] + volume * O[Y] * O[Z];
-    poly->I[Z][X] = poly->I[X][Z];
-    poly->I[Z][Y] = poly->I[Y][Z];
-    poly->I[Z][Z] = I[0] + I[1] - volume * (O[X] * O[X] + O[Y] * O[Y]);
+    poly->Io[X][X] = I[1] + I[2] - volume * (O[Y] * O[Y] + O[Z] * O[Z]);
+    poly->Io[X][Y] = -I[3] + volume * O[X] * O[Y];
+    poly->Io[X][Z] = -I[5] + volume * O[Z] * O[X];
+    poly->Io[Y][X] = poly->Io[X][Y];
+    poly->Io[Y][Y] = I[0] + I[2] - volume * (O[Z] * O[Z] + O[X] * O[X]);
+    poly->Io[Y][Z] = -I[4] + volume * O[Y] * O[Z];
+    poly->Io[Z][X] = poly->Io[X][Z];
+    poly->Io[Z][Y] = poly->Io[Y][Z];
+    poly->Io[Z][Z] = I[0] + I[1] - volume * (O[X] * O[X] + O[Y] * O[Y]);
     for (int s = 0; s < DIMS; ++s) {
-        poly->box[s][MIN] = box[MIN][s];
-        poly->box[s][MAX] = box[MAX][s];
+        poly->bo[s][MIN] = box[MIN][s];
+        poly->bo[s][MAX] = box[MAX][s];
     }
-    /* a radius for estimating maximum velocity */
+    /* a radius for estimating maximum velocity, invariant under the pose */
     poly->r = Dist(box[MIN], box[MAX]);
     /* normalize vertices normal */
     for (int n = 0; n < poly->vertN; ++n) {
@@ -444,8 +737,164 @@ static void ComputeParametersPolyhedron(const int collapse, Polyhedron *poly)
         }
         Normalize(DIMS, Norm(poly->Ne[n]), poly->Ne[n]);
     }
+    BuildHierarchy(poly);
+    return;
+}
+/*
+ * Bounding volume hierarchy
+ * A binary tree of axis-aligned bounding boxes is built top-down by
+ * splitting the face set at the median of face centroids along the longest
+ * extent. Nodes are stored in an array with children always placed after
+ * their parent, hence boxes are refitted by a reverse sweep after rigid
+ * motion without rebuilding the tree.
+ */
+static void BuildHierarchy(Polyhedron *poly)
+{
+    RetrieveStorage(poly->bvh);
+    RetrieveStorage(poly->fo);
+    /* a binary tree with nonempty leaves has at most 2F-1 nodes */
+    poly->bvh = AssignStorage(2 * poly->faceN * sizeof(*poly->bvh));
+    poly->fo = AssignStorage(poly->faceN * sizeof(*poly->fo));
+    Real (*Oc)[DIMS] = AssignStorage(poly->faceN * sizeof(*Oc)); /* face centroids */
+    for (int n = 0; n < poly->faceN; ++n) {
+        poly->fo[n] = n;
+        for (int s = 0; s < DIMS; ++s) {
+            Oc[n][s] = (poly->v[poly->f[n][0]][s] + poly->v[poly->f[n][1]][s] +
+                    poly->v[poly->f[n][2]][s]) * (1.0 / 3.0);
+        }
+    }
+    poly->bvhN = 1;
+    SplitHierarchy(0, 0, poly->faceN, Oc, poly);
+    RetrieveStorage(Oc);
+    RefitHierarchy(poly);
     return;
 }
+static void SplitHierarchy(const int node, const int fm, const int fn,
+        Real Oc[restrict][DIMS], Polyhedron *poly)
+{
+    int *restrict fo = poly->fo;
+    BvhNode *const bvh = poly->bvh;
+    bvh[node].child = NONE;
+    bvh[node].fm = fm;
+    bvh[node].fn = fn;
+    if (BVHLEAF >= fn - fm) {
+        return;
+    }
+    /* choose the longest extent of face centroids */
+    Real box[DIMS][LIMIT] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = FLT_MAX;
+        box[s][MAX] = -FLT_MAX;
+    }
+    for (int m = fm; m < fn; ++m) {
+        for (int s = 0; s < DIMS; ++s) {
+            box[s][MIN] = (box[s][MIN] < Oc[fo[m]][s]) ? box[s][MIN] : Oc[fo[m]][s];
+            box[s][MAX] = (box[s][MAX] > Oc[fo[m]][s]) ? box[s][MAX] : Oc[fo[m]][s];
+        }
+    }
+    int a = X;
+    for (int s = Y; s < DIMS; ++s) {
+        if ((box[s][MAX] - box[s][MIN]) > (box[a][MAX] - box[a][MIN])) {
+            a = s;
+        }
+    }
+    /* partially order faces such that the median separates two halves */
+    const int fk = (fm + fn) / 2;
+    int lo = fm;
+    int hi = fn - 1;
+    while (lo < hi) {
+        const Real pivot = Oc[fo[(lo + hi) / 2]][a];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (Oc[fo[i]][a] < pivot) {
+                ++i;
+            }
+            while (Oc[fo[j]][a] > pivot) {
+                --j;
+            }
+            if (i <= j) {
+                const int temp = fo[i];
+                fo[i] = fo[j];
+                fo[j] = temp;
+                ++i;
+                --j;
+            }
+        }
+        if (fk <= j) {
+            hi = j;
+        } else {
+            if (fk >= i) {
+                lo = i;
+            } else {
+                break;
+            }
+        }
+    }
+    const int child = poly->bvhN;
+    poly->bvhN = poly->bvhN + 2;
+    bvh[node].child = child;
+    SplitHierarchy(child, fm, fk, Oc, poly);
+    SplitHierarchy(child + 1, fk, fn, Oc, poly);
+    return;
+}
+/*
+ * Boxes are slightly inflated to stay conservative against the round-off
+ * error of squared point-triangle distances when pruning.
+ */
+static void RefitHierarchy(Polyhedron *poly)
+{
+    BvhNode *const bvh = poly->bvh;
+    for (int n = poly->bvhN - 1; n >= 0; --n) {
+        for (int s = 0; s < DIMS; ++s) {
+            bvh[n].box[s][MIN] = FLT_MAX;
+            bvh[n].box[s][MAX] = -FLT_MAX;
+        }
+        if (NONE == bvh[n].child) {
+            for (int m = bvh[n].fm; m < bvh[n].fn; ++m) {
+                for (int v = 0; v < POLYN; ++v) {
+                    const Real *const vert = poly->v[poly->f[poly->fo[m]][v]];
+                    for (int s = 0; s < DIMS; ++s) {
+                        bvh[n].box[s][MIN] = (bvh[n].box[s][MIN] < vert[s]) ? bvh[n].box[s][MIN] : vert[s];
+                        bvh[n].box[s][MAX] = (bvh[n].box[s][MAX] > vert[s]) ? bvh[n].box[s][MAX] : vert[s];
+                    }
+                }
+            }
+            continue;
+        }
+        for (int c = bvh[n].child; c < bvh[n].child + 2; ++c) {
+            for (int s = 0; s < DIMS; ++s) {
+                bvh[n].box[s][MIN] = (bvh[n].box[s][MIN] < bvh[c].box[s][MIN]) ? bvh[n].box[s][MIN] : bvh[c].box[s][MIN];
+                bvh[n].box[s][MAX] = (bvh[n].box[s][MAX] > bvh[c].box[s][MAX]) ? bvh[n].box[s][MAX] : bvh[c].box[s][MAX];
+            }
+        }
+    }
+    Real tol = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        tol = (tol > bvh[0].box[s][MAX] - bvh[0].box[s][MIN]) ? tol : bvh[0].box[s][MAX] - bvh[0].box[s][MIN];
+    }
+    tol = 1.0e-6 * tol;
+    for (int n = 0; n < poly->bvhN; ++n) {
+        for (int s = 0; s < DIMS; ++s) {
+            bvh[n].box[s][MIN] = bvh[n].box[s][MIN] - tol;
+            bvh[n].box[s][MAX] = bvh[n].box[s][MAX] + tol;
+        }
+    }
+    return;
+}
+static Real BoxDistance(const Real p[restrict], const Real box[restrict][LIMIT])
+{
+    Real distSquare = 0.0;
+    for (int s = 0; s < DIMS; ++s) {
+        if (box[s][MIN] > p[s]) {
+            distSquare = distSquare + (box[s][MIN] - p[s]) * (box[s][MIN] - p[s]);
+        }
+        if (box[s][MAX] < p[s]) {
+            distSquare = distSquare + (p[s] - box[s][MAX]) * (p[s] - box[s][MAX]);
+        }
+    }
+    return distSquare;
+}
 void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict])
 {
@@ -460,7 +909,47 @@ void BuildTriangle(const int fid, const Polyhedron *poly, Real v0[restrict],
     }
     return;
 }
+/*
+ * Queries of a triangulated polyhedron map the point into the reference
+ * frame of the mesh, hence a rigidly moving mesh is never rewritten and
+ * can be shared by instances.
+ */
 int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[restrict])
+{
+    RealVec q = {0.0}; /* point in reference frame */
+    MapReference(p, poly, q);
+    return LocatePoint(q, poly, fid);
+}
+static int LocatePoint(const Real q[restrict], const Polyhedron *poly, int fid[restrict])
+{
+    const Real zero = 0.0;
+    RealVec pi = {zero}; /* closest point */
+    RealVec N = {zero}; /* normal of the closest point */
+    const int cid = SearchClosestFace(q, poly); /* closest face identifier */
+    *fid = cid;
+    IntersectFace(q, cid, poly, pi, N);
+    pi[X] = q[X] - pi[X];
+    pi[Y] = q[Y] - pi[Y];
+    pi[Z] = q[Z] - pi[Z];
+    if (zero < Dot(pi, N)) {
+        /* outside polyhedron */
+        return 0;
+    } else {
+        /* inside or on polyhedron */
+        return 1;
+    }
+}
+int FindClosestFace(const Real p[restrict], const Polyhedron *poly)
+{
+    RealVec q = {0.0}; /* point in reference frame */
+    MapReference(p, poly, q);
+    return SearchClosestFace(q, poly);
+}
+/*
+ * Branch and bound search of the closest face. Ties are resolved to the
+ * lowest face index, which reproduces the result of an exhaustive search.
+ */
+static int SearchClosestFace(const Real p[restrict], const Polyhedron *poly)
 {
     const Real zero = 0.0;
     RealVec v0 = {zero}; /* vertices */
@@ -468,8 +957,6 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     RealVec v2 = {zero};
     RealVec e01 = {zero}; /* edges */
     RealVec e02 = {zero};
-    RealVec pi = {zero}; /* closest point */
-    RealVec N = {zero}; /* normal of the closest point */
     /*
      * Parametric equation of triangle defined plane
      * T(s,t) = v0 + s(v1-v0) + t(v2-v0) = v0 + s*e01 + t*e02
@@ -483,26 +970,426 @@ int PointInPolyhedron(const Real p[restrict], const Polyhedron *poly, int fid[re
     Real distSquare = zero; /* store computed squared distance */
     Real distSquareMin = FLT_MAX; /* store minimum squared distance */
     int cid = 0; /* closest face identifier */
-    for (int n = 0; n < poly->faceN; ++n) {
-        BuildTriangle(n, poly, v0, v1, v2, e01, e02);
-        distSquare = PointTriangleDistance(p, v0, e01, e02, para);
-        if (distSquareMin > distSquare) {
-            distSquareMin = distSquare;
-            cid = n;
+    if (NULL == poly->bvh) {
+        for (int n = 0; n < poly->faceN; ++n) {
+            BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+            distSquare = PointTriangleDistance(p, v0, e01, e02, para);
+            if (distSquareMin > distSquare) {
+                distSquareMin = distSquare;
+                cid = n;
+            }
         }
+        return cid;
     }
-    *fid = cid;
-    ComputeIntersection(p, cid, poly, pi, N);
-    pi[X] = p[X] - pi[X];
-    pi[Y] = p[Y] - pi[Y];
-    pi[Z] = p[Z] - pi[Z];
-    if (zero < Dot(pi, N)) {
-        /* outside polyhedron */
+    /* the closest face of the nearest sample bounds the search in advance */
+    Real dist = zero; /* distance to the nearest sample */
+    const int m = LocateSample(p, poly, &dist);
+    if (NONE != m) {
+        cid = poly->df.fid[m];
+        BuildTriangle(cid, poly, v0, v1, v2, e01, e02);
+        distSquareMin = PointTriangleDistance(p, v0, e01, e02, para);
+    }
+    const BvhNode *const bvh = poly->bvh;
+    int stack[BVHSTACK] = {0}; /* nodes to be visited */
+    int top = 0;
+    stack[top] = 0;
+    ++top;
+    while (0 < top) {
+        --top;
+        const BvhNode *const node = bvh + stack[top];
+        if (distSquareMin < BoxDistance(p, node->box)) {
+            continue;
+        }
+        if (NONE == node->child) {
+            for (int m = node->fm; m < node->fn; ++m) {
+                const int n = poly->fo[m];
+                BuildTriangle(n, poly, v0, v1, v2, e01, e02);
+                distSquare = PointTriangleDistance(p, v0, e01, e02, para);
+                if ((distSquareMin > distSquare) || ((distSquareMin == distSquare) && (cid > n))) {
+                    distSquareMin = distSquare;
+                    cid = n;
+                }
+            }
+            continue;
+        }
+        /* push the farther child first to visit the nearer one next */
+        const int c = node->child;
+        const int near = (BoxDistance(p, bvh[c].box) > BoxDistance(p, bvh[c + 1].box)) ? c + 1 : c;
+        stack[top] = c + c + 1 - near;
+        stack[top + 1] = near;
+        top = top + 2;
+    }
+    return cid;
+}
+/*
+ * Cell list
+ * Geometries whose bounding boxes overlap the indexed region are entered
+ * into every cell of a uniform grid covered by their bounding boxes. The
+ * cell size follows the mean extent of these geometries, and is enlarged
+ * when the number of cells would exceed a few times the number of
+ * geometries. Entries are gathered cell by cell by counting, hence each
+ * cell lists geometries in ascending order.
+ */
+void BuildCellList(Real region[restrict][LIMIT], Geometry *const geo)
+{
+    CellList *const cl = &(geo->cl);
+    Polyhedron *poly = NULL;
+    int c[DIMS][LIMIT] = {{0}}; /* range of cells */
+    if (NULL == cl->active) {
+        cl->active = AssignStorage((geo->totN + 1) * sizeof(*cl->active));
+        cl->mark = AssignStorage((geo->totN + 1) * sizeof(*cl->mark));
+    }
+    Real h = 0.0; /* cell size */
+    cl->activeN = 0;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if (!BoxOverlap(poly->box, region)) {
+            continue;
+        }
+        cl->active[cl->activeN] = n;
+        ++(cl->activeN);
+        Real extent = 0.0;
+        for (int s = 0; s < DIMS; ++s) {
+            extent = (extent > poly->box[s][MAX] - poly->box[s][MIN]) ? extent : poly->box[s][MAX] - poly->box[s][MIN];
+        }
+        h = h + extent;
+    }
+    RealVec L = {0.0}; /* region extent */
+    for (int s = 0; s < DIMS; ++s) {
+        L[s] = region[s][MAX] - region[s][MIN];
+        cl->s0[s] = region[s][MIN];
+    }
+    if (0 < cl->activeN) {
+        h = h / cl->activeN;
+    }
+    if (0.0 >= h) {
+        h = MaxReal(L[X], MaxReal(L[Y], L[Z]));
+    }
+    const Real cellMax = 8.0 * cl->activeN + 64.0; /* allowed number of cells */
+    while (ceil(L[X] / h) * ceil(L[Y] / h) * ceil(L[Z] / h) > cellMax) {
+        h = 2.0 * h;
+    }
+    cl->h = h;
+    int cellN = 1;
+    for (int s = 0; s < DIMS; ++s) {
+        cl->n[s] = MaxInt(1, (int)ceil(L[s] / h));
+        cellN = cellN * cl->n[s];
+    }
+    if (cl->cellM < cellN + 1) {
+        RetrieveStorage(cl->head);
+        cl->cellM = cellN + 1;
+        cl->head = AssignStorage(cl->cellM * sizeof(*cl->head));
+    }
+    memset(cl->head, 0, (cellN + 1) * sizeof(*cl->head));
+    /* count entries of each cell and convert into cell ends */
+    for (int m = 0; m < cl->activeN; ++m) {
+        CellRange(geo->poly[cl->active[m]].box, cl, c);
+        for (int k = c[Z][MIN]; k < c[Z][MAX]; ++k) {
+            for (int j = c[Y][MIN]; j < c[Y][MAX]; ++j) {
+                for (int i = c[X][MIN]; i < c[X][MAX]; ++i) {
+                    ++(cl->head[IndexNode(k, j, i, cl->n[Y], cl->n[X]) + 1]);
+                }
+            }
+        }
+    }
+    for (int n = 0; n < cellN; ++n) {
+        cl->head[n + 1] = cl->head[n + 1] + cl->head[n];
+    }
+    if (cl->itemM < cl->head[cellN]) {
+        RetrieveStorage(cl->item);
+        cl->itemM = cl->head[cellN];
+        cl->item = AssignStorage(cl->itemM * sizeof(*cl->item));
+    }
+    /* fill entries, cell starts are used as insertion positions */
+    for (int m = 0; m < cl->activeN; ++m) {
+        CellRange(geo->poly[cl->active[m]].box, cl, c);
+        for (int k = c[Z][MIN]; k < c[Z][MAX]; ++k) {
+            for (int j = c[Y][MIN]; j < c[Y][MAX]; ++j) {
+                for (int i = c[X][MIN]; i < c[X][MAX]; ++i) {
+                    const int n = IndexNode(k, j, i, cl->n[Y], cl->n[X]);
+                    cl->item[cl->head[n]] = cl->active[m];
+                    ++(cl->head[n]);
+                }
+            }
+        }
+    }
+    /* insertion positions end as cell ends, shift them back into starts */
+    for (int n = cellN; n > 0; --n) {
+        cl->head[n] = cl->head[n - 1];
+    }
+    cl->head[0] = 0;
+    return;
+}
+int QueryCellList(Real box[restrict][LIMIT], Geometry *const geo, int list[restrict])
+{
+    CellList *const cl = &(geo->cl);
+    int c[DIMS][LIMIT] = {{0}}; /* range of cells */
+    int listN = 0;
+    if (NULL == cl->head) {
         return 0;
-    } else {
-        /* inside or on polyhedron */
+    }
+    ++(cl->stamp);
+    CellRange(box, cl, c);
+    for (int k = c[Z][MIN]; k < c[Z][MAX]; ++k) {
+        for (int j = c[Y][MIN]; j < c[Y][MAX]; ++j) {
+            for (int i = c[X][MIN]; i < c[X][MAX]; ++i) {
+                const int n = IndexNode(k, j, i, cl->n[Y], cl->n[X]);
+                for (int m = cl->head[n]; m < cl->head[n + 1]; ++m) {
+                    const int gid = cl->item[m];
+                    if (cl->stamp == cl->mark[gid]) {
+                        continue;
+                    }
+                    cl->mark[gid] = cl->stamp;
+                    if (BoxOverlap(geo->poly[gid].box, box)) {
+                        list[listN] = gid;
+                        ++listN;
+                    }
+                }
+            }
+        }
+    }
+    return listN;
+}
+static int BoxOverlap(Real a[restrict][LIMIT], Real b[restrict][LIMIT])
+{
+    for (int s = 0; s < DIMS; ++s) {
+        if ((a[s][MIN] > b[s][MAX]) || (a[s][MAX] < b[s][MIN])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+static void CellRange(Real box[restrict][LIMIT], const CellList *cl, int c[restrict][LIMIT])
+{
+    for (int s = 0; s < DIMS; ++s) {
+        /* confine in real numbers to avoid integer overflow */
+        c[s][MIN] = (int)MinReal(MaxReal(floor((box[s][MIN] - cl->s0[s]) / cl->h), 0.0), cl->n[s]);
+        c[s][MAX] = (int)MinReal(MaxReal(floor((box[s][MAX] - cl->s0[s]) / cl->h) + 1.0, 0.0), cl->n[s]);
+    }
+    return;
+}
+/*
+ * Signed distance field
+ * The signed distance to the surface is sampled on a uniform grid covering
+ * the bounding box with one extra layer, together with the closest face of
+ * each sample. Samples are laid in the reference frame of the mesh, hence
+ * the field follows rigid motion and is shared by instances of the mesh.
+ * Since the signed distance is Lipschitz continuous with constant one, the
+ * sign of a point is certain when the distance of the nearest sample
+ * exceeds the distance between the point and the sample. Otherwise, the
+ * point is near the surface and the exact test is required.
+ */
+static void BuildDistanceField(const int N, Polyhedron *poly)
+{
+    DistField *const df = &(poly->df);
+    RetrieveStorage(df->d);
+    RetrieveStorage(df->fid);
+    df->d = NULL; /* disable field queries during construction */
+    df->fid = NULL;
+    Real L = 0.0; /* the longest side */
+    for (int s = 0; s < DIMS; ++s) {
+        L = (L > poly->bo[s][MAX] - poly->bo[s][MIN]) ? L : poly->bo[s][MAX] - poly->bo[s][MIN];
+    }
+    if (0.0 >= L) {
+        return;
+    }
+    df->h = L / N;
+    for (int s = 0; s < DIMS; ++s) {
+        df->n[s] = (int)ceil((poly->bo[s][MAX] - poly->bo[s][MIN]) / df->h) + 3;
+        df->s0[s] = poly->bo[s][MIN] - df->h;
+    }
+    const Real R[DIMS][DIMS] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    const int sampleN = df->n[X] * df->n[Y] * df->n[Z];
+    Real *d = AssignStorage(sampleN * sizeof(*d));
+    int *fid = AssignStorage(sampleN * sizeof(*fid));
+    Real *xc = AssignStorage(poly->faceN * sizeof(*xc));
+    RealVec v0 = {0.0}, v1 = {0.0}, v2 = {0.0}, e01 = {0.0}, e02 = {0.0};
+    RealVec para = {0.0};
+    RealVec q = {0.0}; /* sample point */
+    int cm = 0; /* crossings passed by a sample */
+    int in = 0; /* inside indicator */
+    int f = 0;
+    int idx = 0;
+    for (int k = 0; k < df->n[Z]; ++k) {
+        for (int j = 0; j < df->n[Y]; ++j) {
+            q[Y] = df->s0[Y] + j * df->h;
+            q[Z] = df->s0[Z] + k * df->h;
+            const int crossN = CrossLine(q, R, poly, xc);
+            cm = 0;
+            for (int i = 0; i < df->n[X]; ++i) {
+                q[X] = df->s0[X] + i * df->h;
+                idx = (k * df->n[Y] + j) * df->n[X] + i;
+                fid[idx] = SearchClosestFace(q, poly);
+                BuildTriangle(fid[idx], poly, v0, v1, v2, e01, e02);
+                d[idx] = sqrt(PointTriangleDistance(q, v0, e01, e02, para));
+                while ((0 <= crossN) && (cm < crossN) && (xc[cm] < q[X])) {
+                    ++cm;
+                }
+                if ((0 <= crossN) && ((cm == crossN) || (xc[cm] != q[X]))) {
+                    in = cm % 2;
+                } else {
+                    in = LocatePoint(q, poly, &f);
+                }
+                if (in) {
+                    d[idx] = -d[idx];
+                }
+            }
+        }
+    }
+    RetrieveStorage(xc);
+    df->d = d;
+    df->fid = fid;
+    return;
+}
+/*
+ * Return the nearest sample of a point in the reference frame with its
+ * distance to the point, or NONE if the point is out of the field.
+ */
+static int LocateSample(const Real q[restrict], const Polyhedron *poly, Real dist[restrict])
+{
+    const DistField *const df = &(poly->df);
+    if (NULL == df->d) {
+        return NONE;
+    }
+    RealVec qs = {0.0}; /* nearest sample */
+    IntVec c = {0};
+    for (int s = 0; s < DIMS; ++s) {
+        c[s] = (int)floor((q[s] - df->s0[s]) / df->h + 0.5);
+        if ((0 > c[s]) || (df->n[s] <= c[s])) {
+            return NONE;
+        }
+        qs[s] = df->s0[s] + c[s] * df->h;
+    }
+    *dist = Dist(q, qs);
+    return (c[Z] * df->n[Y] + c[Y]) * df->n[X] + c[X];
+}
+int PointInDistanceField(const Real p[restrict], const Polyhedron *poly)
+{
+    Real dist = 0.0;
+    RealVec q = {0.0}; /* point in reference frame */
+    MapReference(p, poly, q);
+    const int m = LocateSample(q, poly, &dist);
+    if (NONE == m) {
+        return NONE;
+    }
+    dist = dist + 1.0e-6 * poly->df.h; /* guard against rounding of motion */
+    if (dist < poly->df.d[m]) {
+        return 0;
+    }
+    if (-dist > poly->df.d[m]) {
         return 1;
     }
+    return NONE;
+}
+/*
+ * Scanline ray crossing
+ * Crossings are found for the line parallel to x axis by testing the line
+ * point against the projection of each candidate triangle on the y-z plane.
+ * Edge functions are evaluated in a canonical vertex order so that the two
+ * triangles sharing an edge obtain exactly opposite values, which makes the
+ * crossing count watertight. A vanishing edge function means that the line
+ * touches an edge, a vertex, or lies in a face; the line is then reported
+ * as degenerate to let the caller resort to the point-wise test.
+ */
+int ComputeRayCrossing(const Real p[restrict], const Polyhedron *poly, Real xc[restrict])
+{
+    const RealVec dp = {p[X] - poly->D[X], p[Y] - poly->D[Y], p[Z] - poly->D[Z]};
+    const int crossN = CrossLine(dp, poly->R, poly, xc);
+    for (int m = 0; m < crossN; ++m) {
+        xc[m] = xc[m] + poly->D[X];
+    }
+    return crossN;
+}
+/*
+ * The line is culled by the hierarchy in the reference frame, while each
+ * candidate triangle is rotated into the current frame before projection.
+ * Rotating a vertex is deterministic, hence shared edges still obtain
+ * exactly opposite edge functions.
+ */
+static int CrossLine(const Real p[restrict], const Real R[restrict][DIMS],
+        const Polyhedron *poly, Real xc[restrict])
+{
+    const Real zero = 0.0;
+    const BvhNode *const bvh = poly->bvh;
+    const RealVec u = {R[X][X], R[X][Y], R[X][Z]}; /* line direction in reference frame */
+    RealVec q = {zero}; /* line point in reference frame */
+    Real w[POLYN][DIMS] = {{zero}}; /* rotated vertices */
+    RealVec E = {zero}; /* edge functions */
+    for (int s = 0; s < DIMS; ++s) {
+        q[s] = R[X][s] * p[X] + R[Y][s] * p[Y] + R[Z][s] * p[Z];
+    }
+    int crossN = 0;
+    int stack[BVHSTACK] = {0}; /* nodes to be visited */
+    int top = 0;
+    stack[top] = 0;
+    ++top;
+    while (0 < top) {
+        --top;
+        const BvhNode *const node = bvh + stack[top];
+        Real tMin = -FLT_MAX; /* line parameter range inside the box */
+        Real tMax = FLT_MAX;
+        for (int s = 0; s < DIMS; ++s) {
+            if (zero == u[s]) {
+                if ((node->box[s][MIN] > q[s]) || (node->box[s][MAX] < q[s])) {
+                    tMin = FLT_MAX;
+                    tMax = -FLT_MAX;
+                }
+                continue;
+            }
+            const Real t0 = (node->box[s][MIN] - q[s]) / u[s];
+            const Real t1 = (node->box[s][MAX] - q[s]) / u[s];
+            tMin = MaxReal(tMin, MinReal(t0, t1));
+            tMax = MinReal(tMax, MaxReal(t0, t1));
+        }
+        if (tMin > tMax) {
+            continue;
+        }
+        if (NONE != node->child) {
+            stack[top] = node->child;
+            stack[top + 1] = node->child + 1;
+            top = top + 2;
+            continue;
+        }
+        for (int m = node->fm; m < node->fn; ++m) {
+            const int n = poly->fo[m];
+            for (int v = 0; v < POLYN; ++v) {
+                for (int s = 0; s < DIMS; ++s) {
+                    w[v][s] = Dot(R[s], poly->v[poly->f[n][v]]);
+                }
+            }
+            E[0] = EdgeFunction(p, w[1], w[2]);
+            E[1] = EdgeFunction(p, w[2], w[0]);
+            E[2] = EdgeFunction(p, w[0], w[1]);
+            if (((zero < E[0]) && (zero < E[1]) && (zero < E[2])) ||
+                    ((zero > E[0]) && (zero > E[1]) && (zero > E[2]))) {
+                xc[crossN] = (E[0] * w[0][X] + E[1] * w[1][X] + E[2] * w[2][X]) / (E[0] + E[1] + E[2]);
+                ++crossN;
+                continue;
+            }
+            if (((zero <= E[0]) && (zero <= E[1]) && (zero <= E[2])) ||
+                    ((zero >= E[0]) && (zero >= E[1]) && (zero >= E[2]))) {
+                return NONE; /* on the boundary of a projected triangle */
+            }
+        }
+    }
+    /* sort crossings in ascending order */
+    for (int m = 1; m < crossN; ++m) {
+        const Real temp = xc[m];
+        int n = m - 1;
+        while ((0 <= n) && (xc[n] > temp)) {
+            xc[n + 1] = xc[n];
+            --n;
+        }
+        xc[n + 1] = temp;
+    }
+    return crossN;
+}
+static Real EdgeFunction(const Real p[restrict], const Real va[restrict], const Real vb[restrict])
+{
+    if ((va[Y] > vb[Y]) || ((va[Y] == vb[Y]) && (va[Z] > vb[Z]))) {
+        return -((va[Y] - vb[Y]) * (p[Z] - vb[Z]) - (va[Z] - vb[Z]) * (p[Y] - vb[Y]));
+    }
+    return (vb[Y] - va[Y]) * (p[Z] - va[Z]) - (vb[Z] - va[Z]) * (p[Y] - va[Y]);
 }
 /*
  * Eberly, D. (1999). Distance between point and triangle in 3D.
@@ -688,6 +1575,20 @@ Real PointTriangleDistance(const Real p[restrict], const Real v0[restrict], cons
 }
 Real ComputeIntersection(const Real p[restrict], const int fid,
         const Polyhedron *poly, Real pi[restrict], Real N[restrict])
+{
+    RealVec q = {0.0}; /* point in reference frame */
+    RealVec qi = {0.0};
+    RealVec Nq = {0.0};
+    MapReference(p, poly, q);
+    const Real distSquare = IntersectFace(q, fid, poly, qi, Nq);
+    for (int s = 0; s < DIMS; ++s) {
+        pi[s] = Dot(poly->R[s], qi) + poly->D[s];
+        N[s] = Dot(poly->R[s], Nq);
+    }
+    return distSquare;
+}
+static Real IntersectFace(const Real p[restrict], const int fid,
+        const Polyhedron *poly, Real pi[restrict], Real N[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
@@ -28,13 +28,28 @@
  *
  * Function
  *      Convert polyhedron representation from STL to a mixture form
- *      of face-vertex mesh and winged-edge mesh.
+ *      of face-vertex mesh and winged-edge mesh. Vertices within the weld
+ *      tolerance are merged when it is positive. The edge list is built
+ *      from the face-vertex list, and the number of edges that are not
+ *      shared by exactly two faces is returned.
  */
-extern void ConvertPolyhedron(Polyhedron *);
+extern void ConvertPolyhedron(const Real weld, Polyhedron *);
 extern void AllocatePolyhedronMemory(const int vertN, const int edgeN,
         const int faceN, Polyhedron *);
-extern void AddEdge(const int v0, const int v1, const int f, Polyhedron *);
+extern int BuildEdgeList(Polyhedron *);
 extern void QuickSortEdge(const int n, int e[restrict][EVF]);
+/*
+ * Shared mesh
+ *
+ * Function
+ *      Let a polyhedron share the mesh of an owner with geometry identifier
+ *      gid, instead of holding a copy. The mesh is kept in its reference
+ *      frame, and each polyhedron is placed by its own pose.
+ *      Vertex mapping returns a vertex of the mesh in the current frame.
+ *      Note that the triangle built from a mesh is in the reference frame.
+ */
+extern void SharePolyhedronMesh(const int gid, const Polyhedron *owner, Polyhedron *);
+extern void MapVertex(const int vid, const Polyhedron *, Real v[restrict]);
 extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
         Real v1[restrict], Real v2[restrict], Real e01[restrict], Real e02[restrict]);
 /*
@@ -45,10 +60,29 @@ extern void BuildTriangle(const int fid, const Polyhedron *, Real v0[restrict],
  *      volume, area, volume, centroid, inertia tensor, normal. Note that the
  *      inertia tensor is relative to the body coordinates located at centroid
  *      and is computed by assuming that the density is a constant with value 1.
+ *      A bounding volume hierarchy of faces is also built for each triangulated
+ *      polyhedron and refitted when the polyhedron is scaled. If enabled,
+ *      a signed distance field is sampled in the reference frame of each
+ *      mesh and follows its rigid motion. Shared meshes are computed once.
  */
 extern void ComputeGeometryParameters(const int collapse, Geometry *const);
+/*
+ * Cell list of geometries
+ *
+ * Function
+ *      Index the bounding boxes of geometries overlapping a region by a
+ *      uniform grid of cells, and collect the geometries overlapping the
+ *      region in ascending order. The query returns the number of indexed
+ *      geometries whose bounding boxes overlap a box and stores them in list.
+ */
+extern void BuildCellList(Real region[restrict][LIMIT], Geometry *const);
+extern int QueryCellList(Real box[restrict][LIMIT], Geometry *const, int list[restrict]);
 /*
  * Polyhedron transformation
+ *
+ * Function
+ *      Scale, rotate, and translate a polyhedron about point O. Rigid
+ *      motion updates the pose only, while scaling rewrites the mesh.
  */
 extern void TransformPolyhedron(const Real O[restrict], const Real scale[restrict],
         const Real angle[restrict], const Real offset[restrict], Polyhedron *);
@@ -57,9 +91,35 @@ extern void TransformPolyhedron(const Real O[restrict], const Real scale[restric
  *
  * Function
  *      Solve point-in-polyhedron problem for triangulated polyhedron,
- *      also find the cloest face.
+ *      also find the cloest face through the bounding volume hierarchy.
  */
 extern int PointInPolyhedron(const Real p[restrict], const Polyhedron *, int fid[restrict]);
+/*
+ * Closest face
+ *
+ * Function
+ *      Find the face of a triangulated polyhedron closest to a point.
+ */
+extern int FindClosestFace(const Real p[restrict], const Polyhedron *);
+/*
+ * Point in distance field
+ *
+ * Function
+ *      Classify a point by the signed distance field of a triangulated
+ *      polyhedron. Returns 1 if inside, 0 if outside, and NONE if the point
+ *      is near the surface, out of the field, or no field is sampled.
+ */
+extern int PointInDistanceField(const Real p[restrict], const Polyhedron *);
+/*
+ * Scanline ray crossing
+ *
+ * Function
+ *      Find the crossings of the line parallel to x axis through a point
+ *      with the surface of a triangulated polyhedron. Crossings are stored
+ *      in ascending order of x coordinate and the number of crossings is
+ *      returned. NONE is returned if the line touches an edge or a vertex.
+ */
+extern int ComputeRayCrossing(const Real p[restrict], const Polyhedron *, Real xc[restrict]);
 /*
  * Point triangle distance
  *
@@ -12,6 +12,8 @@
  * Required Header Files
  ****************************************************************************/
 #include "convective_flux.h"
+#include <string.h> /* manipulating strings */
+#include <math.h> /* common mathematical functions */
 #include "weno.h"
 #include "cfd_commons.h"
 #include "commons.h"
@@ -20,106 +22,286 @@
  ****************************************************************************/
 typedef enum {
     FDN = 5, /* width of the direct stencil */
-    FTN = 6, /* width of the entire stencil */
+    FBATCH = 16, /* number of interfaces reconstructed in a batch */
+    FLANE = 2 * FBATCH * DIMU, /* lanes of a batch, forward and backward fields */
 } FhatConst;
+/*
+ * Kernels are generated for each combination of spatial scheme, flux
+ * splitting, Jacobian average, and sweep direction. Every kernel expands
+ * the same inline routines with these options as constants, so that the
+ * compiler folds the branches and index math of the options away and
+ * optimizes the whole chain of each combination as straight-line code.
+ */
+#if defined(__GNUC__)
+#define FHAT_INLINE inline __attribute__((always_inline))
+#else
+#define FHAT_INLINE inline
+#endif
+#define FHAT_KERNEL(scheme, splitter, averager, s) \
+static void Fhat##scheme##splitter##averager##s(const int mMin, const int mMax, \
+        Real Up[restrict][DIMU], Real Pp[restrict][DIMUc], const Model *model, \
+        Real Fhat[restrict][DIMU]) \
+{ \
+    ReconstructLine(scheme, splitter, averager, s, mMin, mMax, Up, Pp, model, Fhat); \
+    return; \
+}
+#define FHAT_KERNEL_DIMS(scheme, splitter, averager) \
+    FHAT_KERNEL(scheme, splitter, averager, 0) \
+    FHAT_KERNEL(scheme, splitter, averager, 1) \
+    FHAT_KERNEL(scheme, splitter, averager, 2)
+#define FHAT_ENTRY_DIMS(scheme, splitter, averager) \
+    {Fhat##scheme##splitter##averager##0, \
+        Fhat##scheme##splitter##averager##1, \
+        Fhat##scheme##splitter##averager##2}
 /****************************************************************************
- * Function Pointers
+ * Static Function Declarations
  ****************************************************************************/
-typedef void (*FhatReconstructor)(Real [restrict][DIMU], Real [restrict]);
+static FHAT_INLINE void ReconstructLine(const int, const int, const int, const int,
+        const int, const int, Real [restrict][DIMU], Real [restrict][DIMUc],
+        const Model *, Real [restrict][DIMU]);
+static FHAT_INLINE void ProjectInterface(const int, const int, const int, const int,
+        const int, const int, const int, const int, Real [restrict][DIMU],
+        Real [restrict][DIMUc], const Model *, Real [restrict], Real [restrict][FLANE]);
+static FHAT_INLINE void AverageInterface(const int, const Model *, const Real [restrict],
+        const Real [restrict], const Real *, const Real *, Real [restrict]);
+static FHAT_INLINE void SplitEigenvalue(const int, const Real, const Real, Real [restrict],
+        Real [restrict]);
+static FHAT_INLINE void InverseProjection(const int, const Real [restrict],
+        const Real [restrict], const Real [restrict], Real [restrict]);
 /****************************************************************************
- * Static Function Declarations
+ * Specialized Kernels
  ****************************************************************************/
-static void CharacteristicVariable(const int, const int, const int, const int,
-        const int, const int, const int, const int [restrict], const Node *const,
-        Real [restrict][DIMU], Real [restrict][DIMU]);
-static void CharacteristicFlux(const Real [restrict], Real [restrict][DIMU],
-        const int, const int, const int,  Real [restrict][DIMU]);
-static void InverseProjection(Real [restrict][DIMU], const Real [restrict],
-        const Real [restrict], Real [restrict]);
+FHAT_KERNEL_DIMS(0, 0, 0)
+FHAT_KERNEL_DIMS(0, 0, 1)
+FHAT_KERNEL_DIMS(0, 1, 0)
+FHAT_KERNEL_DIMS(0, 1, 1)
+FHAT_KERNEL_DIMS(1, 0, 0)
+FHAT_KERNEL_DIMS(1, 0, 1)
+FHAT_KERNEL_DIMS(1, 1, 0)
+FHAT_KERNEL_DIMS(1, 1, 1)
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static FhatReconstructor ReconstructFhat[2] = {
-    WENO3,
-    WENO5};
+static FhatKernel FhatKernels[2][2][2][DIMS] = { /* [scheme][splitter][averager][s] */
+    {{FHAT_ENTRY_DIMS(0, 0, 0), FHAT_ENTRY_DIMS(0, 0, 1)},
+        {FHAT_ENTRY_DIMS(0, 1, 0), FHAT_ENTRY_DIMS(0, 1, 1)}},
+    {{FHAT_ENTRY_DIMS(1, 0, 0), FHAT_ENTRY_DIMS(1, 0, 1)},
+        {FHAT_ENTRY_DIMS(1, 1, 0), FHAT_ENTRY_DIMS(1, 1, 1)}}};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
-void ComputeFhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Node *const node, const Model *model, Real Fhat[restrict])
+FhatKernel SelectFhatKernel(const int s, const Model *model)
+{
+    return FhatKernels[model->sScheme][model->fluxSplit][model->jacobMean][s];
+}
+/*
+ * The pencil holds a whole grid line, including the ghost nodes required by
+ * the stencil, in contiguous memory. Therefore, every interface along the
+ * line is reconstructed with unit-stride access, no matter which direction
+ * the sweep goes. The primitive pencil, if not NULL, holds the cached
+ * primitives of the same nodes.
+ *
+ * Interfaces are processed in batches. The characteristic flux stencils of
+ * each field of a batch are laid out as lanes of a structure of arrays, then
+ * all the lanes are reconstructed by one call of the batched WENO kernel.
+ */
+static FHAT_INLINE void ReconstructLine(const int scheme, const int splitter,
+        const int averager, const int s, const int mMin, const int mMax,
+        Real Up[restrict][DIMU], Real Pp[restrict][DIMUc], const Model *model,
+        Real Fhat[restrict][DIMU])
+{
+    /* stencil offsets, the same as the ones of the model */
+    const int sL = (WENOTHREE == scheme) ? -1 : -2;
+    const int sR = (WENOTHREE == scheme) ? 2 : 3;
+    Real H[FDN][FLANE]; /* characteristic flux stencils of a batch */
+    Real Hhat[FLANE]; /* numerical flux of characteristic fields of a batch */
+    Real Uo[FBATCH][DIMUo]; /* averaged primitives of each interface */
+    for (int m0 = mMin; m0 < mMax; m0 = m0 + FBATCH) {
+        const int nI = MinInt(FBATCH, mMax - m0);
+        const int nL = ((2 * nI * DIMU + WENOLANE - 1) / WENOLANE) * WENOLANE;
+        for (int q = 0; q < nI; ++q) {
+            ProjectInterface(splitter, averager, s, sL, sR, m0 + q, q * DIMU,
+                    (nI + q) * DIMU, Up, Pp, model, Uo[q], H);
+        }
+        for (int n = 0; n < FDN; ++n) { /* padding lanes */
+            memset(H[n] + 2 * nI * DIMU, 0, (nL - 2 * nI * DIMU) * sizeof(Real));
+        }
+        if (WENOTHREE == scheme) {
+            WENO3Batch(nL, FLANE, H[0], Hhat);
+        } else {
+            WENO5Batch(nL, FLANE, H[0], Hhat);
+        }
+        for (int q = 0; q < nI; ++q) {
+            InverseProjection(s, Uo[q], Hhat + q * DIMU, Hhat + (nI + q) * DIMU, Fhat[m0+q]);
+        }
+    }
+    return;
+}
+/*
+ * Project the stencil of interface m+1/2 onto characteristic fields, and
+ * store the forward and backward characteristic flux stencils into lanes
+ * starting from lP and lN, respectively.
+ *
+ * The left eigenvectors are never assembled. Rows of L share the term
+ * G = b * ((u, v, w) . (U1, U2, U3) - q * U0 - U4), with which the acoustic
+ * fields are -G +/- d * (Vn * U0 - Un), the entropy field is U0 + 2 * G,
+ * and the shear fields are Ut + 2 * Vt * G. Here, the subscripts n and t
+ * denote the normal and the transverse components of direction s.
+ */
+static FHAT_INLINE void ProjectInterface(const int splitter, const int averager,
+        const int s, const int sL, const int sR, const int m, const int lP, const int lN,
+        Real Up[restrict][DIMU], Real Pp[restrict][DIMUc], const Model *model,
+        Real Uo[restrict], Real H[restrict][FLANE])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    const int idxL = IndexNode(k, j, i, partn[Y], partn[X]);
-    const int idxR = IndexNode(k + h[s][Z], j + h[s][Y], i + h[s][X], partn[Y], partn[X]);
+    const int a = s + 1; /* normal component */
+    const int t1 = (s + 1) % DIMS + 1; /* transverse component */
+    const int t2 = (s + 2) % DIMS + 1; /* transverse component */
+    const int tot = sR - sL; /* width of the direct stencil */
     /* evaluate interface values by averaging */
-    Real Uo[DIMUo]; /* store averaged primitives */
-    SymmetricAverage(model->jacobMean, model->gamma, node[idxL].U[tn], node[idxR].U[tn], Uo);
-    /* decompose Jacobian matrix */
-    Real Lambda[DIMU]; /* eigenvalues */
-    Real L[DIMU][DIMU]; /* vector space {Ln} */
-    Real R[DIMU][DIMU]; /* vector space {Rn} */
-    Eigenvalue(s, Uo, Lambda);
-    EigenvectorL(s, model->gamma, Uo, L);
-    EigenvectorR(s, Uo, R);
+    if (NULL == Pp) {
+        AverageInterface(averager, model, Up[m], Up[m+1], NULL, NULL, Uo);
+    } else {
+        AverageInterface(averager, model, Up[m], Up[m+1], Pp[m], Pp[m+1], Uo);
+    }
+    const Real c = Uo[5];
+    const Real q = 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]);
+    const Real b = (model->gamma - 1.0) / (2.0 * c * c);
+    const Real d = 1.0 / (2.0 * c);
     /* flux vector splitting */
     Real LambdaP[DIMU]; /* eigenvalues */
     Real LambdaN[DIMU]; /* eigenvalues */
-    EigenvalueSplitting(model->fluxSplit, Lambda, LambdaP, LambdaN);
-    /* construct local characteristic variables for all potential stencils */
-    Real W[FTN][DIMU];
-    CharacteristicVariable(tn, s, k, j, i, model->sL, model->sR, partn, node, L, W);
-    /* construct local characteristic fluxes */
-    Real HP[FDN][DIMU]; /* forward characteristic flux stencil */
-    Real HN[FDN][DIMU]; /* backward characteristic flux stencil */
-    CharacteristicFlux(LambdaP, W, 0, +1, model->sR - model->sL, HP);
-    CharacteristicFlux(LambdaN, W, model->sR - model->sL, -1, model->sR - model->sL, HN);
-    /* WENO reconstruction */
-    Real HhatP[DIMU]; /* forward numerical flux of characteristic fields */
-    Real HhatN[DIMU]; /* backward numerical flux of characteristic fields */
-    ReconstructFhat[model->sScheme](HP, HhatP);
-    ReconstructFhat[model->sScheme](HN, HhatN);
-    /* inverse projection */
-    InverseProjection(R, HhatP, HhatN, Fhat);
+    SplitEigenvalue(splitter, Uo[a], c, LambdaP, LambdaN);
+    /* characteristic variables and fluxes of each stencil node */
+    Real W[DIMU];
+    for (int n = sL, l = 0; n <= sR; ++n, ++l) {
+        const Real *restrict U = Up[m+n];
+        const Real G = b * (Uo[1] * U[1] + Uo[2] * U[2] + Uo[3] * U[3] - q * U[0] - U[4]);
+        const Real A = d * (Uo[a] * U[0] - U[a]);
+        W[0] = A - G;
+        W[a] = U[0] + 2.0 * G;
+        W[t1] = U[t1] + 2.0 * Uo[t1] * G;
+        W[t2] = U[t2] + 2.0 * Uo[t2] * G;
+        W[4] = -A - G;
+        if (tot > l) { /* forward stencil takes nodes sL to sR - 1 */
+            for (int r = 0; r < DIMU; ++r) {
+                H[l][lP+r] = LambdaP[r] * W[r];
+            }
+        }
+        if (0 < l) { /* backward stencil takes nodes sR to sL + 1 */
+            for (int r = 0; r < DIMU; ++r) {
+                H[tot-l][lN+r] = LambdaN[r] * W[r];
+            }
+        }
+    }
     return;
 }
-static void CharacteristicVariable(const int tn, const int s, const int k, const int j,
-        const int i, const int sL, const int sR, const int partn[restrict],
-        const Node *const node, Real L[restrict][DIMU], Real W[restrict][DIMU])
+/*
+ * Evaluate the primitives u, v, w, hT, and c at the interface between two
+ * nodes by the arithmetic mean or the Roe average. Node primitives are taken
+ * from the cached PL and PR when given, where hT = cp * T + (u^2+v^2+w^2)/2
+ * needs no division, otherwise they are computed from UL and UR.
+ */
+static FHAT_INLINE void AverageInterface(const int averager, const Model *model,
+        const Real UL[restrict], const Real UR[restrict], const Real *PL,
+        const Real *PR, Real Uo[restrict])
 {
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    int idx = 0; /* linear array index math variable */
-    const Real *restrict U = NULL;
-    for (int n = sL, m = 0; n <= sR; ++n, ++m) {
-        idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], partn[Y], partn[X]);
-        U = node[idx].U[tn];
-        for (int r = 0; r < DIMU; ++r) {
-            W[m][r] = 0.0;
-            for (int c = 0; c < DIMU; ++c) {
-                W[m][r] = W[m][r] + L[r][c] * U[c];
-            }
-        }
+    const Real gamma = model->gamma;
+    const Real cp = gamma * model->cv;
+    Real uL = 0.0, vL = 0.0, wL = 0.0, hTL = 0.0;
+    Real uR = 0.0, vR = 0.0, wR = 0.0, hTR = 0.0;
+    if (NULL == PL) {
+        uL = UL[1] / UL[0];
+        vL = UL[2] / UL[0];
+        wL = UL[3] / UL[0];
+        hTL = (UL[4] / UL[0]) * gamma - 0.5 * (uL * uL + vL * vL + wL * wL) * (gamma - 1.0);
+        uR = UR[1] / UR[0];
+        vR = UR[2] / UR[0];
+        wR = UR[3] / UR[0];
+        hTR = (UR[4] / UR[0]) * gamma - 0.5 * (uR * uR + vR * vR + wR * wR) * (gamma - 1.0);
+    } else {
+        uL = PL[1];
+        vL = PL[2];
+        wL = PL[3];
+        hTL = cp * PL[5] + 0.5 * (uL * uL + vL * vL + wL * wL);
+        uR = PR[1];
+        vR = PR[2];
+        wR = PR[3];
+        hTR = cp * PR[5] + 0.5 * (uR * uR + vR * vR + wR * wR);
+    }
+    const Real rhoL = UL[0];
+    const Real rhoR = UR[0];
+    Real D = 0.0;
+    switch (averager) {
+        case 0: /* arithmetic mean */
+            Uo[1] = 0.5 * (uL + uR); /* u average */
+            Uo[2] = 0.5 * (vL + vR); /* v average */
+            Uo[3] = 0.5 * (wL + wR); /* w average */
+            Uo[4] = 0.5 * (hTL + hTR); /* hT average */
+            break;
+        case 1: /* Roe average */
+            D = sqrt(rhoR / rhoL);
+            Uo[1] = (uL + D * uR) / (1.0 + D); /* u average */
+            Uo[2] = (vL + D * vR) / (1.0 + D); /* v average */
+            Uo[3] = (wL + D * wR) / (1.0 + D); /* w average */
+            Uo[4] = (hTL + D * hTR) / (1.0 + D); /* hT average */
+            break;
+        default:
+            break;
     }
+    Uo[5] = sqrt((gamma - 1.0) * (Uo[4] - 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]))); /* the speed of sound */
     return;
 }
-static void CharacteristicFlux(const Real Lambda[restrict], Real W[restrict][DIMU],
-        const int start, const int wind, const int tot, Real H[restrict][DIMU])
+/*
+ * Split eigenvalues Vn - c, Vn, Vn, Vn, Vn + c into positive and negative parts.
+ */
+static FHAT_INLINE void SplitEigenvalue(const int splitter, const Real Vn, const Real c,
+        Real LambdaP[restrict], Real LambdaN[restrict])
 {
-    for (int n = start, m = 0; m < tot; n = n + wind, ++m) {
-        for (int r = 0; r < DIMU; ++r) {
-            H[m][r] = Lambda[r] * W[n][r];
-        }
+    const Real Lambda[DIMU] = {Vn - c, Vn, Vn, Vn, Vn + c};
+    const Real epsilon = 1.0e-3;
+    Real lambdaStar = 0.0;
+    switch (splitter) {
+        case 0: /* local Lax-Friedrichs, set local maximum as (|Vs| + c) */
+            lambdaStar = fabs(Vn) + c;
+            for (int r = 0; r < DIMU; ++r) {
+                LambdaP[r] = 0.5 * (Lambda[r] + lambdaStar);
+                LambdaN[r] = 0.5 * (Lambda[r] - lambdaStar);
+            }
+            break;
+        default: /* Steger-Warming */
+            for (int r = 0; r < DIMU; ++r) {
+                lambdaStar = sqrt(Lambda[r] * Lambda[r] + epsilon * epsilon);
+                LambdaP[r] = 0.5 * (Lambda[r] + lambdaStar);
+                LambdaN[r] = 0.5 * (Lambda[r] - lambdaStar);
+            }
+            break;
     }
     return;
 }
-static void InverseProjection(Real R[restrict][DIMU], const Real HhatP[restrict],
+/*
+ * Fhat = R * (HhatP + HhatN), with the right eigenvectors applied by their
+ * sparse structure instead of a dense product.
+ */
+static FHAT_INLINE void InverseProjection(const int s, const Real Uo[restrict], const Real HhatP[restrict],
         const Real HhatN[restrict], Real Fhat[restrict])
 {
+    const int a = s + 1; /* normal component */
+    const int t1 = (s + 1) % DIMS + 1; /* transverse component */
+    const int t2 = (s + 2) % DIMS + 1; /* transverse component */
+    const Real c = Uo[5];
+    const Real q = 0.5 * (Uo[1] * Uo[1] + Uo[2] * Uo[2] + Uo[3] * Uo[3]);
+    Real h[DIMU];
     for (int r = 0; r < DIMU; ++r) {
-        Fhat[r] = 0.0;
-        for (int c = 0; c < DIMU; ++c) {
-            Fhat[r] = Fhat[r] + R[r][c] * (HhatP[c] + HhatN[c]);
-        }
+        h[r] = HhatP[r] + HhatN[r];
     }
+    const Real hA = h[0] + h[4]; /* sum of acoustic fields */
+    const Real hD = h[4] - h[0]; /* difference of acoustic fields */
+    Fhat[0] = hA + h[a];
+    Fhat[a] = Uo[a] * (hA + h[a]) + c * hD;
+    Fhat[t1] = Uo[t1] * hA + h[t1];
+    Fhat[t2] = Uo[t2] * hA + h[t2];
+    Fhat[4] = Uo[4] * hA + Uo[a] * c * hD + (Uo[a] * Uo[a] - q) * h[a] +
+        Uo[t1] * h[t1] + Uo[t2] * h[t2];
     return;
 }
 /* a good practice: end file with a newline */
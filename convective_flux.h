@@ -20,18 +20,32 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+/****************************************************************************
+ * Function Pointers
+ ****************************************************************************/
+/*
+ * Convective flux kernel
+ *
+ * Function
+ *      reconstruct the numerical convective flux at interfaces m+1/2 for m
+ *      in [mMin, mMax) of a pencil, which stores the conservative vectors of
+ *      a grid line gathered along the sweep direction. The primitive pencil
+ *      stores the cached primitives of the same nodes, or is NULL if the
+ *      primitive cache does not hold the time level.
+ */
+typedef void (*FhatKernel)(const int, const int, Real [restrict][DIMU],
+        Real [restrict][DIMUc], const Model *, Real [restrict][DIMU]);
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
 /*
- * Convective flux
+ * Convective flux kernel selection
  *
  * Function
- *      reconstruct the numerical convective flux.
+ *      Get the convective flux kernel specialized for sweep direction s and
+ *      the spatial scheme, flux splitting, and Jacobian average of model.
  */
-extern void ComputeFhat(const int tn, const int s, const int k, const int j,
-        const int i, const int partn[restrict], const Node *const,
-        const Model *, Real Fhat[restrict]);
+extern FhatKernel SelectFhatKernel(const int s, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
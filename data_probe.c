@@ -14,7 +14,6 @@
 #include "data_probe.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* support for abs operation */
-#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -28,7 +27,7 @@ void WritePointProbeData(const Time *time, const Space *space, const Model *mode
     FILE *fp = NULL;
     String fname = {'\0'};
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     int idx = 0; /* linear array index math variable */
     Real Uo[DIMUo] = {0.0};
     const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
@@ -51,7 +50,7 @@ void WritePointProbeData(const Time *time, const Space *space, const Model *mode
         j = ConfineSpace(MapNode(p1[Y], sMin[Y], dd[Y], ng[Y]), nMin[Y], nMax[Y]);
         k = ConfineSpace(MapNode(p1[Z], sMin[Z], dd[Z], ng[Z]), nMin[Z], nMax[Z]);
         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-        MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+        LoadPrimitive(TO, idx, field, model, Uo);
         fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                 time->now, Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         fclose(fp);
@@ -66,7 +65,7 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
     FILE *fp = NULL;
     String fname = {'\0'};
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     int idx = 0; /* linear array index math variable */
     int idxOld = 0; /* linear array index math variable */
     Real Uo[DIMUo] = {0.0};
@@ -108,7 +107,7 @@ void WriteLineProbeData(const Time *time, const Space *space, const Model *model
             p2[X] = MapPoint(i, sMin[X], d[X], ng[X]);
             p2[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
             p2[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-            MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
+            LoadPrimitive(TO, idx, field, model, Uo);
             fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
                     p2[X], p2[Y], p2[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         }
@@ -123,49 +122,23 @@ void WriteCurveProbeData(const Time *time, const Space *space, const Model *mode
     }
     FILE *fp = NULL;
     String fname = {'\0'};
-    const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
+    const Ghost *ghost = NULL;
     Real Uo[DIMUo] = {0.0};
-    const IntVec nMin = {part->ns[PHY][X][MIN], part->ns[PHY][Y][MIN], part->ns[PHY][Z][MIN]};
-    const IntVec nMax = {part->ns[PHY][X][MAX], part->ns[PHY][Y][MAX], part->ns[PHY][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    RealVec pG = {0.0}; /* ghost point */
-    RealVec pO = {0.0}; /* boundary point */
-    RealVec pI = {0.0}; /* image point */
-    RealVec N = {0.0}; /* normal */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         snprintf(fname, sizeof(fname), "%s%03d_%05d.csv", "curve_probe_", n + 1, time->stepC);
         fp = Fopen(fname, "w");
         fprintf(fp, "# x, y, z, Nx, Ny, Nz, rho, u, v, w, p, T <time=%.6g>\n", time->now);
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].gst) || (n + 1 != node[idx].did)) {
-                        continue;
-                    }
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
-                            pO[X], pO[Y], pO[Z], N[X], N[Y], N[Z], Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
-                }
-            }
+        /* ghost nodes of the first layer */
+        for (int m = poly->gs[0]; m < poly->gs[1]; ++m) {
+            ghost = poly->ghost + m;
+            LoadPrimitive(TO, ghost->idx, field, model, Uo);
+            fprintf(fp, "%.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g, %.6g\n",
+                    ghost->pO[X], ghost->pO[Y], ghost->pO[Z], ghost->N[X], ghost->N[Y], ghost->N[Z],
+                    Uo[0], Uo[1], Uo[2], Uo[3], Uo[4], Uo[5]);
         }
         fclose(fp);
     }
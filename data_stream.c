@@ -15,10 +15,34 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include <float.h> /* size of floating point values */
+#include <pthread.h> /* POSIX threads */
+#ifdef _OPENMP
+#include <omp.h> /* shared memory parallelization */
+#endif
 #include "paraview.h"
 #include "ensight.h"
 #include "data_probe.h"
+#include "checkpoint.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    Time time; /* time state of the snapshot */
+    Space space; /* space data referring to the staged field and geometry */
+} Snapshot;
+typedef struct {
+    int slotN; /* number of staging slots, 0 if writing synchronously */
+    int head; /* the oldest staged slot */
+    int count; /* number of staged slots */
+    int quit; /* termination tag of the writer */
+    const Model *model; /* model shared by all snapshots */
+    Snapshot *slot; /* staging slots used as a ring buffer */
+    pthread_t writer; /* background writer thread */
+    pthread_mutex_t lock; /* lock of the ring buffer states */
+    pthread_cond_t staged; /* signalled when a slot is staged */
+    pthread_cond_t freed; /* signalled when a slot is written */
+} Pipeline; /* asynchronous writing pipeline of space data */
 /****************************************************************************
  * Function Pointers
  ****************************************************************************/
@@ -38,6 +62,8 @@ static void ReadFieldData(Time *, Space *, const Model *);
 static void WriteGeometryData(const Time *, const Geometry *const);
 static void ReadGeometryData(const Time *, Geometry *const);
 static void WriteStateData(const Time *);
+static void StageSpaceData(const Time *, const Space *);
+static void *RunDataWriter(void *);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
@@ -65,14 +91,154 @@ static PolyDataWriter WritePolyData[2] = {
 static PolyDataReader ReadPolyData[2] = {
     ReadPolyDataParaview,
     ReadPolyDataEnsight};
+static Pipeline pipeline; /* inactive unless started */
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
 void WriteData(const int n, const Time *time, const Space *space, const Model *model)
 {
+    if ((PROSD == n) && (0 < pipeline.slotN)) {
+        StageSpaceData(time, space);
+        return;
+    }
     UnifiedWriteData[n](time, space, model);
     return;
 }
+/*
+ * Asynchronous writing of space data
+ *
+ * Space data are copied into a ring of staging slots and written by a
+ * background thread through the same writers, so the time marching only
+ * pays for the copy. When all slots are in use, staging blocks until the
+ * writer frees one, which bounds the memory of pending snapshots. Staged
+ * geometries share the meshes of the run, which stay unchanged as rigid
+ * motions only update the pose of polyhedrons.
+ */
+void StartDataPipeline(const Time *time, const Space *space, const Model *model)
+{
+    if (0 >= time->dataQueue) {
+        return;
+    }
+    const Partition *const part = &(space->part);
+    const Geometry *const geo = &(space->geo);
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    pipeline.slotN = time->dataQueue;
+    pipeline.head = 0;
+    pipeline.count = 0;
+    pipeline.quit = 0;
+    pipeline.model = model;
+    pipeline.slot = AssignStorage(pipeline.slotN * sizeof(*pipeline.slot));
+    for (int m = 0; m < pipeline.slotN; ++m) {
+        Field *const field = &(pipeline.slot[m].space.field);
+        field->store = AssignStorage(nodeN * (DIMU * sizeof(Real) + 4 * sizeof(int)));
+        Real *const U = field->store;
+        for (int n = 0; n < DIMU; ++n) {
+            field->U[TO][n] = U + n * nodeN;
+        }
+        int *const id = (int *)(U + DIMU * nodeN);
+        field->did = id;
+        field->fid = id + nodeN;
+        field->lid = id + 2 * nodeN;
+        field->gst = id + 3 * nodeN;
+        field->tl = 1;
+        field->tc = NONE; /* writers compute primitives from the staged data */
+        field->tv = NONE;
+        if (0 < geo->totN) {
+            pipeline.slot[m].space.geo.poly = AssignStorage(geo->totN * sizeof(*geo->poly));
+        }
+    }
+    if ((0 != pthread_mutex_init(&(pipeline.lock), NULL)) ||
+            (0 != pthread_cond_init(&(pipeline.staged), NULL)) ||
+            (0 != pthread_cond_init(&(pipeline.freed), NULL)) ||
+            (0 != pthread_create(&(pipeline.writer), NULL, RunDataWriter, NULL))) {
+        ShowError("failed to start the data pipeline");
+    }
+    return;
+}
+void FinishDataPipeline(void)
+{
+    if (0 >= pipeline.slotN) {
+        return;
+    }
+    pthread_mutex_lock(&(pipeline.lock));
+    pipeline.quit = 1;
+    pthread_cond_signal(&(pipeline.staged));
+    pthread_mutex_unlock(&(pipeline.lock));
+    pthread_join(pipeline.writer, NULL); /* pending snapshots are written before exit */
+    pthread_cond_destroy(&(pipeline.freed));
+    pthread_cond_destroy(&(pipeline.staged));
+    pthread_mutex_destroy(&(pipeline.lock));
+    for (int m = 0; m < pipeline.slotN; ++m) {
+        RetrieveStorage(pipeline.slot[m].space.field.store);
+        RetrieveStorage(pipeline.slot[m].space.geo.poly);
+    }
+    RetrieveStorage(pipeline.slot);
+    pipeline.slot = NULL;
+    pipeline.slotN = 0;
+    return;
+}
+static void StageSpaceData(const Time *time, const Space *space)
+{
+    pthread_mutex_lock(&(pipeline.lock));
+    while (pipeline.slotN == pipeline.count) { /* backpressure */
+        pthread_cond_wait(&(pipeline.freed), &(pipeline.lock));
+    }
+    Snapshot *const snap = pipeline.slot + (pipeline.head + pipeline.count) % pipeline.slotN;
+    pthread_mutex_unlock(&(pipeline.lock));
+    /* the slot is owned by the caller until it is counted as staged */
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
+    const int nodeN = part->n[X] * part->n[Y] * part->n[Z];
+    Field *const staged = &(snap->space.field);
+    Polyhedron *const poly = snap->space.geo.poly;
+    for (int n = 0; n < DIMU; ++n) {
+        memcpy(staged->U[TO][n], field->U[TO][n], nodeN * sizeof(Real));
+    }
+    memcpy(staged->did, field->did, nodeN * sizeof(int));
+    memcpy(staged->fid, field->fid, nodeN * sizeof(int));
+    memcpy(staged->lid, field->lid, nodeN * sizeof(int));
+    memcpy(staged->gst, field->gst, nodeN * sizeof(int));
+    if (0 < geo->totN) {
+        memcpy(poly, geo->poly, geo->totN * sizeof(*poly));
+    }
+    snap->time = *time;
+    snap->space.part = *part;
+    snap->space.geo = *geo;
+    snap->space.geo.poly = poly;
+    pthread_mutex_lock(&(pipeline.lock));
+    ++(pipeline.count);
+    pthread_cond_signal(&(pipeline.staged));
+    pthread_mutex_unlock(&(pipeline.lock));
+    return;
+}
+static void *RunDataWriter(void *arg)
+{
+    (void)arg;
+#ifdef _OPENMP
+    omp_set_num_threads(1); /* leave the cores to the time marching */
+#endif
+    Snapshot *snap = NULL;
+    while (1) {
+        pthread_mutex_lock(&(pipeline.lock));
+        while ((0 == pipeline.count) && (0 == pipeline.quit)) {
+            pthread_cond_wait(&(pipeline.staged), &(pipeline.lock));
+        }
+        if (0 == pipeline.count) { /* quit after draining */
+            pthread_mutex_unlock(&(pipeline.lock));
+            break;
+        }
+        snap = pipeline.slot + pipeline.head;
+        pthread_mutex_unlock(&(pipeline.lock));
+        WriteSpaceData(&(snap->time), &(snap->space), pipeline.model);
+        pthread_mutex_lock(&(pipeline.lock));
+        pipeline.head = (pipeline.head + 1) % pipeline.slotN;
+        --(pipeline.count);
+        pthread_cond_signal(&(pipeline.freed));
+        pthread_mutex_unlock(&(pipeline.lock));
+    }
+    return NULL;
+}
 void ReadData(const int n, Time *time, Space *space, const Model *model)
 {
     UnifiedReadData[n](time, space, model);
@@ -82,11 +248,18 @@ static void WriteSpaceData(const Time *time, const Space *space, const Model *mo
 {
     WriteFieldData(time, space, model);
     WriteGeometryData(time, &(space->geo));
+    if (0 != time->restartFormat) {
+        WriteCheckpoint(time, space);
+    }
     WriteStateData(time);
     return;
 }
 static void ReadSpaceData(Time *time, Space *space, const Model *model)
 {
+    if (0 != time->restartFormat) {
+        ReadCheckpoint(time, space);
+        return;
+    }
     ReadFieldData(time, space, model);
     ReadGeometryData(time, &(space->geo));
     return;
@@ -25,6 +25,8 @@
  ****************************************************************************/
 extern void WriteData(const int n, const Time *, const Space *, const Model *);
 extern void ReadData(const int n, Time *, Space *, const Model *);
+extern void StartDataPipeline(const Time *, const Space *, const Model *);
+extern void FinishDataPipeline(void);
 extern void WritePolyStateData(const int pm, const int pn, FILE *fp, const Geometry *const);
 extern void ReadPolyStateData(const int pm, const int pn, FILE *fp, Geometry *const);
 #endif
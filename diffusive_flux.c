@@ -19,20 +19,24 @@
  * Function Pointers
  ****************************************************************************/
 typedef void (*FvhatReconstructor)(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void ComputeFvhatX(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 static void ComputeFvhatY(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
 static void ComputeFvhatZ(const int, const int, const int, const int,
-        const int [restrict], const Real [restrict], const Node *const,
+        const int [restrict], const Real [restrict], const Field *const,
         const Model *, Real [restrict]);
+static Real NodeVelocity(const int, const int, Real *const [restrict],
+        Real *const [restrict]);
+static Real NodeTemperature(const int, const Real, Real *const [restrict],
+        Real *const [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
@@ -44,7 +48,7 @@ static FvhatReconstructor ReconstructFvhat[DIMS] = {
  * Function definitions
  ****************************************************************************/
 void ComputeFvhat(const int tn, const int s, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int partn[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
     const Real zero = 0.0;
@@ -52,11 +56,11 @@ void ComputeFvhat(const int tn, const int s, const int k, const int j, const int
         memset(Fvhat, 0, DIMU * sizeof(*Fvhat));
         return;
     }
-    ReconstructFvhat[s](tn, k, j, i, partn, dd, node, model, Fvhat);
+    ReconstructFvhat[s](tn, k, j, i, partn, dd, field, model, Fvhat);
     return;
 }
 static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int partn[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
@@ -71,49 +75,41 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
     const int idxFE = IndexNode(k - 1, j, i + 1, partn[Y], partn[X]);
     const int idxBE = IndexNode(k + 1, j, i + 1, partn[Y], partn[X]);
 
-    const Real *restrict U = node[idx].U[tn];
-    const Real u = U[1] / U[0];
-    const Real v = U[2] / U[0];
-    const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    Real *const *const U = field->U[tn];
+    Real *const *const Uc = (tn == field->tc) ? field->Uc : NULL; /* primitive cache */
+    const Real u = NodeVelocity(1, idx, U, Uc);
+    const Real v = NodeVelocity(2, idx, U, Uc);
+    const Real w = NodeVelocity(3, idx, U, Uc);
+    const Real T = NodeTemperature(idx, model->cv, U, Uc);
 
-    U = node[idxS].U[tn];
-    const Real uS = U[1] / U[0];
-    const Real vS = U[2] / U[0];
+    const Real uS = NodeVelocity(1, idxS, U, Uc);
+    const Real vS = NodeVelocity(2, idxS, U, Uc);
 
-    U = node[idxN].U[tn];
-    const Real uN = U[1] / U[0];
-    const Real vN = U[2] / U[0];
+    const Real uN = NodeVelocity(1, idxN, U, Uc);
+    const Real vN = NodeVelocity(2, idxN, U, Uc);
 
-    U = node[idxF].U[tn];
-    const Real uF = U[1] / U[0];
-    const Real wF = U[3] / U[0];
+    const Real uF = NodeVelocity(1, idxF, U, Uc);
+    const Real wF = NodeVelocity(3, idxF, U, Uc);
 
-    U = node[idxB].U[tn];
-    const Real uB = U[1] / U[0];
-    const Real wB = U[3] / U[0];
+    const Real uB = NodeVelocity(1, idxB, U, Uc);
+    const Real wB = NodeVelocity(3, idxB, U, Uc);
 
-    U = node[idxE].U[tn];
-    const Real uE = U[1] / U[0];
-    const Real vE = U[2] / U[0];
-    const Real wE = U[3] / U[0];
-    const Real TE = ComputeTemperature(model->cv, U);
+    const Real uE = NodeVelocity(1, idxE, U, Uc);
+    const Real vE = NodeVelocity(2, idxE, U, Uc);
+    const Real wE = NodeVelocity(3, idxE, U, Uc);
+    const Real TE = NodeTemperature(idxE, model->cv, U, Uc);
 
-    U = node[idxSE].U[tn];
-    const Real uSE = U[1] / U[0];
-    const Real vSE = U[2] / U[0];
+    const Real uSE = NodeVelocity(1, idxSE, U, Uc);
+    const Real vSE = NodeVelocity(2, idxSE, U, Uc);
 
-    U = node[idxNE].U[tn];
-    const Real uNE = U[1] / U[0];
-    const Real vNE = U[2] / U[0];
+    const Real uNE = NodeVelocity(1, idxNE, U, Uc);
+    const Real vNE = NodeVelocity(2, idxNE, U, Uc);
 
-    U = node[idxFE].U[tn];
-    const Real uFE = U[1] / U[0];
-    const Real wFE = U[3] / U[0];
+    const Real uFE = NodeVelocity(1, idxFE, U, Uc);
+    const Real wFE = NodeVelocity(3, idxFE, U, Uc);
 
-    U = node[idxBE].U[tn];
-    const Real uBE = U[1] / U[0];
-    const Real wBE = U[3] / U[0];
+    const Real uBE = NodeVelocity(1, idxBE, U, Uc);
+    const Real wBE = NodeVelocity(3, idxBE, U, Uc);
 
     const Real du_dx = (uE - u) * dd[X];
     const Real dv_dy = 0.25 * (vN + vNE - vS - vSE) * dd[Y];
@@ -141,7 +137,7 @@ static void ComputeFvhatX(const int tn, const int k, const int j, const int i,
     return;
 }
 static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int partn[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
@@ -156,49 +152,41 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
     const int idxFN = IndexNode(k - 1, j + 1, i, partn[Y], partn[X]);
     const int idxBN = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
 
-    const Real *restrict U = node[idx].U[tn];
-    const Real u = U[1] / U[0];
-    const Real v = U[2] / U[0];
-    const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    Real *const *const U = field->U[tn];
+    Real *const *const Uc = (tn == field->tc) ? field->Uc : NULL; /* primitive cache */
+    const Real u = NodeVelocity(1, idx, U, Uc);
+    const Real v = NodeVelocity(2, idx, U, Uc);
+    const Real w = NodeVelocity(3, idx, U, Uc);
+    const Real T = NodeTemperature(idx, model->cv, U, Uc);
 
-    U = node[idxW].U[tn];
-    const Real uW = U[1] / U[0];
-    const Real vW = U[2] / U[0];
+    const Real uW = NodeVelocity(1, idxW, U, Uc);
+    const Real vW = NodeVelocity(2, idxW, U, Uc);
 
-    U = node[idxE].U[tn];
-    const Real uE = U[1] / U[0];
-    const Real vE = U[2] / U[0];
+    const Real uE = NodeVelocity(1, idxE, U, Uc);
+    const Real vE = NodeVelocity(2, idxE, U, Uc);
 
-    U = node[idxF].U[tn];
-    const Real vF = U[2] / U[0];
-    const Real wF = U[3] / U[0];
+    const Real vF = NodeVelocity(2, idxF, U, Uc);
+    const Real wF = NodeVelocity(3, idxF, U, Uc);
 
-    U = node[idxB].U[tn];
-    const Real vB = U[2] / U[0];
-    const Real wB = U[3] / U[0];
+    const Real vB = NodeVelocity(2, idxB, U, Uc);
+    const Real wB = NodeVelocity(3, idxB, U, Uc);
 
-    U = node[idxN].U[tn];
-    const Real uN = U[1] / U[0];
-    const Real vN = U[2] / U[0];
-    const Real wN = U[3] / U[0];
-    const Real TN = ComputeTemperature(model->cv, U);
+    const Real uN = NodeVelocity(1, idxN, U, Uc);
+    const Real vN = NodeVelocity(2, idxN, U, Uc);
+    const Real wN = NodeVelocity(3, idxN, U, Uc);
+    const Real TN = NodeTemperature(idxN, model->cv, U, Uc);
 
-    U = node[idxWN].U[tn];
-    const Real uWN = U[1] / U[0];
-    const Real vWN = U[2] / U[0];
+    const Real uWN = NodeVelocity(1, idxWN, U, Uc);
+    const Real vWN = NodeVelocity(2, idxWN, U, Uc);
 
-    U = node[idxEN].U[tn];
-    const Real uEN = U[1] / U[0];
-    const Real vEN = U[2] / U[0];
+    const Real uEN = NodeVelocity(1, idxEN, U, Uc);
+    const Real vEN = NodeVelocity(2, idxEN, U, Uc);
 
-    U = node[idxFN].U[tn];
-    const Real vFN = U[2] / U[0];
-    const Real wFN = U[3] / U[0];
+    const Real vFN = NodeVelocity(2, idxFN, U, Uc);
+    const Real wFN = NodeVelocity(3, idxFN, U, Uc);
 
-    U = node[idxBN].U[tn];
-    const Real vBN = U[2] / U[0];
-    const Real wBN = U[3] / U[0];
+    const Real vBN = NodeVelocity(2, idxBN, U, Uc);
+    const Real wBN = NodeVelocity(3, idxBN, U, Uc);
 
     const Real dv_dx = 0.25 * (vE + vEN - vW - vWN) * dd[X];
     const Real du_dy = (uN - u) * dd[Y];
@@ -226,7 +214,7 @@ static void ComputeFvhatY(const int tn, const int k, const int j, const int i,
     return ;
 }
 static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
-        const int partn[restrict], const Real dd[restrict], const Node *const node,
+        const int partn[restrict], const Real dd[restrict], const Field *const field,
         const Model *model, Real Fvhat[restrict])
 {
     const int idx = IndexNode(k, j, i, partn[Y], partn[X]);
@@ -241,49 +229,41 @@ static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
     const int idxSB = IndexNode(k + 1, j - 1, i, partn[Y], partn[X]);
     const int idxNB = IndexNode(k + 1, j + 1, i, partn[Y], partn[X]);
 
-    const Real *restrict U = node[idx].U[tn];
-    const Real u = U[1] / U[0];
-    const Real v = U[2] / U[0];
-    const Real w = U[3] / U[0];
-    const Real T = ComputeTemperature(model->cv, U);
+    Real *const *const U = field->U[tn];
+    Real *const *const Uc = (tn == field->tc) ? field->Uc : NULL; /* primitive cache */
+    const Real u = NodeVelocity(1, idx, U, Uc);
+    const Real v = NodeVelocity(2, idx, U, Uc);
+    const Real w = NodeVelocity(3, idx, U, Uc);
+    const Real T = NodeTemperature(idx, model->cv, U, Uc);
 
-    U = node[idxW].U[tn];
-    const Real uW = U[1] / U[0];
-    const Real wW = U[3] / U[0];
+    const Real uW = NodeVelocity(1, idxW, U, Uc);
+    const Real wW = NodeVelocity(3, idxW, U, Uc);
 
-    U = node[idxE].U[tn];
-    const Real uE = U[1] / U[0];
-    const Real wE = U[3] / U[0];
+    const Real uE = NodeVelocity(1, idxE, U, Uc);
+    const Real wE = NodeVelocity(3, idxE, U, Uc);
 
-    U = node[idxS].U[tn];
-    const Real vS = U[2] / U[0];
-    const Real wS = U[3] / U[0];
+    const Real vS = NodeVelocity(2, idxS, U, Uc);
+    const Real wS = NodeVelocity(3, idxS, U, Uc);
 
-    U = node[idxN].U[tn];
-    const Real vN = U[2] / U[0];
-    const Real wN = U[3] / U[0];
+    const Real vN = NodeVelocity(2, idxN, U, Uc);
+    const Real wN = NodeVelocity(3, idxN, U, Uc);
 
-    U = node[idxB].U[tn];
-    const Real uB = U[1] / U[0];
-    const Real vB = U[2] / U[0];
-    const Real wB = U[3] / U[0];
-    const Real TB = ComputeTemperature(model->cv, U);
+    const Real uB = NodeVelocity(1, idxB, U, Uc);
+    const Real vB = NodeVelocity(2, idxB, U, Uc);
+    const Real wB = NodeVelocity(3, idxB, U, Uc);
+    const Real TB = NodeTemperature(idxB, model->cv, U, Uc);
 
-    U = node[idxWB].U[tn];
-    const Real uWB = U[1] / U[0];
-    const Real wWB = U[3] / U[0];
+    const Real uWB = NodeVelocity(1, idxWB, U, Uc);
+    const Real wWB = NodeVelocity(3, idxWB, U, Uc);
 
-    U = node[idxEB].U[tn];
-    const Real uEB = U[1] / U[0];
-    const Real wEB = U[3] / U[0];
+    const Real uEB = NodeVelocity(1, idxEB, U, Uc);
+    const Real wEB = NodeVelocity(3, idxEB, U, Uc);
 
-    U = node[idxSB].U[tn];
-    const Real vSB = U[2] / U[0];
-    const Real wSB = U[3] / U[0];
+    const Real vSB = NodeVelocity(2, idxSB, U, Uc);
+    const Real wSB = NodeVelocity(3, idxSB, U, Uc);
 
-    U = node[idxNB].U[tn];
-    const Real vNB = U[2] / U[0];
-    const Real wNB = U[3] / U[0];
+    const Real vNB = NodeVelocity(2, idxNB, U, Uc);
+    const Real wNB = NodeVelocity(3, idxNB, U, Uc);
 
     const Real dw_dx = 0.25 * (wE + wEB - wW - wWB) * dd[X];
     const Real du_dz = (uB - u) * dd[Z];
@@ -310,5 +290,28 @@ static void ComputeFvhatZ(const int tn, const int k, const int j, const int i,
     Fvhat[4] = heatK * dT_dz + Fvhat[1] * uhat + Fvhat[2] * vhat + Fvhat[3] * what;
     return;
 }
+/*
+ * Velocity component and temperature of a node are taken from the primitive
+ * cache when it holds the time level, otherwise they are computed from the
+ * conservative variables.
+ */
+static Real NodeVelocity(const int n, const int idx, Real *const U[restrict],
+        Real *const Uc[restrict])
+{
+    if (NULL != Uc) {
+        return Uc[n][idx];
+    }
+    return U[n][idx] / U[0][idx];
+}
+static Real NodeTemperature(const int idx, const Real cv, Real *const U[restrict],
+        Real *const Uc[restrict])
+{
+    if (NULL != Uc) {
+        return Uc[5][idx];
+    }
+    Real UT[DIMU] = {0.0}; /* conservative vector for temperature */
+    LoadU(idx, U, UT);
+    return ComputeTemperature(cv, UT);
+}
 /* a good practice: end file with a newline */
 
@@ -31,7 +31,7 @@
  */
 extern void ComputeFvhat(const int tn, const int s, const int k, const int j,
         const int i, const int partn[restrict], const Real dd[restrict],
-        const Node *const, const Model *, Real Fvhat[restrict]);
+        const Field *const, const Model *, Real Fvhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -67,8 +67,8 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
     FILE *fp = NULL;
     EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL;
+    Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
     for (int s = 0; s < enSet->scaN; ++s) {
         snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
@@ -84,23 +84,27 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                         idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                         if (0 == s) {
                             /* geometric field initializer */
-                            node[idx].did = NONE;
-                            node[idx].fid = NONE;
-                            node[idx].lid = NONE;
-                            node[idx].gst = NONE;
-                            memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                            field->did[idx] = NONE;
+                            field->fid[idx] = NONE;
+                            field->lid[idx] = NONE;
+                            field->gst[idx] = NONE;
+                            for (int tn = 0; tn < field->tl; ++tn) {
+                                for (int n = 0; n < DIMU; ++n) {
+                                    memset(field->U[tn][n] + idx, 1, sizeof(Real));
+                                }
+                            }
                             if (InPartBox(k, j, i, part->ns[PIN])) {
-                                node[idx].did = 0;
-                                node[idx].fid = 0;
-                                node[idx].lid = 0;
-                                node[idx].gst = 0;
+                                field->did[idx] = 0;
+                                field->fid[idx] = 0;
+                                field->lid[idx] = 0;
+                                field->gst[idx] = 0;
                             }
                         }
                         if (!InPartBox(k, j, i, part->ns[p])) {
                             continue;
                         }
                         /* data field initializer */
-                        U = node[idx].U[TO];
+                        LoadU(idx, field->U[TO], U);
                         Fread(&data, sizeof(EnReal), 1, fp);
                         switch (s) {
                             case 0: /* rho */
@@ -122,6 +126,7 @@ static void ReadStructuredData(Space *space, const Model *model, EnSet *enSet)
                             default:
                                 break;
                         }
+                        StoreU(idx, U, field->U[TO]);
                     }
                 }
             }
@@ -203,7 +208,6 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Fread(enSet->str, sizeof(EnStr), 1, fp);
         Fread(&ne, sizeof(int), 1, fp);
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
                 Fread(&data, sizeof(EnReal), 1, fp);
@@ -217,11 +221,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
                 Fread(&m, sizeof(int), 1, fp);
                 poly->f[n][s] = m - 1;
             }
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdgeList(poly);
     }
     ReadPolyState(pm, pn, geo, enSet);
     return;
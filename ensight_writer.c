@@ -14,7 +14,11 @@
 #include "ensight.h"
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* shared memory parallelization */
+#endif
 #include "data_stream.h"
+#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -24,6 +28,7 @@ static void InitializeTransientCaseFile(EnSet *);
 static void WriteCaseFile(const Time *, EnSet *);
 static void WriteGeometryFile(const Space *, EnSet *);
 static void WriteStructuredData(const Space *, const Model *, EnSet *);
+static size_t PackNodeData(const int, const int, const Space *, const Model *, EnReal *);
 static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, EnSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
@@ -138,9 +143,10 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
      */
     snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->rname);
     FILE *fp = Fopen(enSet->fname, "wb");
-    EnReal data = 0.0; /* the Ensight data format */
+    EnReal *data = NULL; /* the Ensight data format */
     const Partition *const part = &(space->part);
     IntVec ne = {0}; /* i, j, k node number in each part */
+    size_t nodeN = 0; /* number of nodes in each part */
     /* description at the beginning */
     strncpy(enSet->str, "C Binary", sizeof(EnStr));
     fwrite(enSet->str, sizeof(EnStr), 1, fp);
@@ -165,17 +171,22 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
         ne[Y] = part->ns[p][Y][MAX] - part->ns[p][Y][MIN];
         ne[Z] = part->ns[p][Z][MAX] - part->ns[p][Z][MIN];
         fwrite(ne, sizeof(int), 3, fp);
-        for (int s = 0; s < DIMS; ++s) {
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        ne[X] = i; ne[Y] = j; ne[Z] = k;
-                        data = MapPoint(ne[s], part->domain[s][MIN], part->d[s], part->ng[s]);
-                        fwrite(&data, sizeof(EnReal), 1, fp);
-                    }
+        /* coordinates of a part are gathered and written at once */
+        nodeN = (size_t)ne[X] * ne[Y] * ne[Z];
+        data = AssignStorage(DIMS * nodeN * sizeof(*data));
+#pragma omp parallel for collapse(2) schedule(static)
+        for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
+            for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
+                size_t m = ((size_t)(k - part->ns[p][Z][MIN]) * ne[Y] + (j - part->ns[p][Y][MIN])) * ne[X];
+                for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i, ++m) {
+                    data[m] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
+                    data[nodeN + m] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
+                    data[2 * nodeN + m] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
                 }
             }
         }
+        fwrite(data, sizeof(EnReal), DIMS * nodeN, fp);
+        RetrieveStorage(data);
     }
     fclose(fp);
     return;
@@ -184,94 +195,115 @@ static void WriteGeometryFile(const Space *space, EnSet *enSet)
  * The values for each node of the structured block are output in
  * the same IJK order as the coordinates. (The number of nodes in the
  * part are obtained from the corresponding geometry file.)
+ * Variable files are independent, hence threads write different files at
+ * the same time, each variable of a part is gathered into a buffer and
+ * written at once. Vector files are the largest and are taken first.
+ * The team is no larger than the number of files, and a thread sizes its
+ * buffer by the files it actually takes.
  */
 static void WriteStructuredData(const Space *space, const Model *model, EnSet *enSet)
 {
-    FILE *fp = NULL;
-    EnReal data = 0.0; /* the Ensight data format */
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
-    const Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
-    for (int s = 0; s < enSet->scaN; ++s) {
-        snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->sca[s]);
-        fp = Fopen(enSet->fname, "wb");
-        /* first line description per file */
-        strncpy(enSet->str, "scalar variable", sizeof(EnStr));
-        fwrite(enSet->str, sizeof(EnStr), 1, fp);
-        for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
-            /* binary file format */
-            strncpy(enSet->str, "part", sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            fwrite(&pnum, sizeof(int), 1, fp);
-            strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            /* now output the scalar value at each node in current part */
-            for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                    for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
-                        switch (s) {
-                            case 0: /* rho */
-                                data = U[0];
-                                break;
-                            case 1: /* u */
-                                data = U[1] / U[0];
-                                break;
-                            case 2: /* v */
-                                data = U[2] / U[0];
-                                break;
-                            case 3: /* w */
-                                data = U[3] / U[0];
-                                break;
-                            case 4: /* p */
-                                data = ComputePressure(model->gamma, U);
-                                break;
-                            case 5: /* T */
-                                data = ComputeTemperature(model->cv, U);
-                                break;
-                            case 6: /* node flag */
-                                data = node[idx].did;
-                                break;
-                            default:
-                                break;
-                        }
-                        fwrite(&data, sizeof(EnReal), 1, fp);
+    const int varN = enSet->vecN + enSet->scaN;
+    size_t nodeM = 0; /* maximum number of nodes in a part */
+    for (int p = enSet->part[MIN]; p < enSet->part[MAX]; ++p) {
+        const size_t nodeN = (size_t)(part->ns[p][X][MAX] - part->ns[p][X][MIN]) *
+            (part->ns[p][Y][MAX] - part->ns[p][Y][MIN]) * (part->ns[p][Z][MAX] - part->ns[p][Z][MIN]);
+        nodeM = (nodeM > nodeN) ? nodeM : nodeN;
+    }
+#ifdef _OPENMP
+    const int threadN = MinInt(varN, omp_get_max_threads());
+#endif
+#pragma omp parallel num_threads(threadN)
+    {
+        EnStr fname = {'\0'}; /* file name of the variable */
+        EnStr str = {'\0'}; /* string data */
+        EnReal *data = NULL; /* the Ensight data format */
+        size_t dataM = 0; /* capacity of buffer */
+        size_t dataN = 0; /* number of data in buffer */
+        FILE *fp = NULL;
+#pragma omp for schedule(dynamic, 1)
+        for (int v = 0; v < varN; ++v) {
+            const int vec = (enSet->vecN > v); /* vector variable */
+            const int s = vec ? v : v - enSet->vecN; /* variable index */
+            if ((vec ? DIMS * nodeM : nodeM) > dataM) {
+                dataM = vec ? DIMS * nodeM : nodeM;
+                RetrieveStorage(data);
+                data = AssignStorage(dataM * sizeof(*data));
+            }
+            snprintf(fname, sizeof(EnStr), "%s.%s", enSet->bname, vec ? enSet->vec[s] : enSet->sca[s]);
+            fp = Fopen(fname, "wb");
+            /* first line description per file, binary file format */
+            strncpy(str, vec ? "vector variable" : "scalar variable", sizeof(EnStr));
+            fwrite(str, sizeof(EnStr), 1, fp);
+            for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
+                strncpy(str, "part", sizeof(EnStr));
+                fwrite(str, sizeof(EnStr), 1, fp);
+                fwrite(&pnum, sizeof(int), 1, fp);
+                strncpy(str, enSet->dtype, sizeof(EnStr));
+                fwrite(str, sizeof(EnStr), 1, fp);
+                /* now output the value at each node in current part */
+                if (vec) {
+                    dataN = 0;
+                    for (int n = 1; n < 4; ++n) { /* velocity components are the scalars u, v, w */
+                        dataN = dataN + PackNodeData(p, n, space, model, data + dataN);
                     }
+                } else {
+                    dataN = PackNodeData(p, s, space, model, data);
                 }
+                fwrite(data, sizeof(EnReal), dataN, fp);
             }
+            fclose(fp);
         }
-        fclose(fp);
+        RetrieveStorage(data);
     }
-    for (int s = 0; s < enSet->vecN; ++s) {
-        snprintf(enSet->fname, sizeof(EnStr), "%s.%s", enSet->bname, enSet->vec[s]);
-        fp = Fopen(enSet->fname, "wb");
-        /* binary file format */
-        strncpy(enSet->str, "vector variable", sizeof(EnStr));
-        fwrite(enSet->str, sizeof(EnStr), 1, fp);
-        for (int p = enSet->part[MIN], pnum = 1; p < enSet->part[MAX]; ++p, ++pnum) {
-            strncpy(enSet->str, "part", sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            fwrite(&pnum, sizeof(int), 1, fp);
-            strncpy(enSet->str, enSet->dtype, sizeof(EnStr));
-            fwrite(enSet->str, sizeof(EnStr), 1, fp);
-            for (int n = 1; n < 4; ++n) {
-                for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
-                    for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
-                        for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i) {
-                            idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                            U = node[idx].U[TO];
-                            data = U[n] / U[0];
-                            fwrite(&data, sizeof(EnReal), 1, fp);
-                        }
-                    }
+    return;
+}
+static size_t PackNodeData(const int p, const int s, const Space *space, const Model *model, EnReal *data)
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
+    int idx = 0; /* linear array index math variable */
+    size_t m = 0; /* data count */
+    for (int k = part->ns[p][Z][MIN]; k < part->ns[p][Z][MAX]; ++k) {
+        for (int j = part->ns[p][Y][MIN]; j < part->ns[p][Y][MAX]; ++j) {
+            for (int i = part->ns[p][X][MIN]; i < part->ns[p][X][MAX]; ++i, ++m) {
+                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if ((TO == field->tc) && (DIMUc > s)) { /* primitive variables from cache */
+                    data[m] = field->Uc[s][idx];
+                    continue;
+                }
+                LoadU(idx, field->U[TO], U);
+                switch (s) {
+                    case 0: /* rho */
+                        data[m] = U[0];
+                        break;
+                    case 1: /* u */
+                        data[m] = U[1] / U[0];
+                        break;
+                    case 2: /* v */
+                        data[m] = U[2] / U[0];
+                        break;
+                    case 3: /* w */
+                        data[m] = U[3] / U[0];
+                        break;
+                    case 4: /* p */
+                        data[m] = ComputePressure(model->gamma, U);
+                        break;
+                    case 5: /* T */
+                        data[m] = ComputeTemperature(model->cv, U);
+                        break;
+                    case 6: /* node flag */
+                        data[m] = field->did[idx];
+                        break;
+                    default:
+                        break;
                 }
             }
         }
-        fclose(fp);
     }
-    return;
+    return m;
 }
 void WritePolyDataEnsight(const Time *time, const Geometry *const geo)
 {
@@ -385,6 +417,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     snprintf(enSet->fname, sizeof(EnStr), "%s.geo", enSet->bname);
     FILE *fp = Fopen(enSet->fname, "wb");
     EnReal data = 0.0; /* the Ensight data format */
+    RealVec v = {0.0}; /* vertex in current frame */
     const Polyhedron *poly = NULL;
     int ne = 0; /* total number of nodes in a part */
     /* description at the beginning */
@@ -413,7 +446,8 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fwrite(&ne, sizeof(int), 1, fp);
         for (int s = 0; s < DIMS; ++s) {
             for (int n = 0; n < poly->vertN; ++n) {
-                data = poly->v[n][s];
+                MapVertex(n, poly, v);
+                data = v[s];
                 fwrite(&data, sizeof(EnReal), 1, fp);
             }
         }
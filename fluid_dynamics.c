@@ -25,22 +25,32 @@ typedef void (*TimeIntegrator)(const Real, const int, Space *, const Model *);
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
+static int SweepOrder(const int, int [restrict]);
 static void DiscretizeTime(const Real, const int, Space *, const Model *);
 static void RungeKutta2(const Real, const int, Space *, const Model *);
 static void RungeKutta3(const Real, const int, Space *, const Model *);
+static void RungeKutta3LS(const Real, const int, Space *, const Model *);
+static void UpdateRegister(const Real, const int, const int, Space *, const Model *);
 static void LLLU(const Real, const Real, const Real, const int,
         const int, const int, const int, Space *, const Model *);
 static void LU(const Real [restrict], const Real [restrict],
         const Real [restrict], const Real [restrict], Real [restrict]);
-static void SolveOperator(const int, const int, const Real, const Real,
-        const Real [restrict], const Real [restrict], Real [restrict], const Real,
+static void MapLineNode(const int, const int, const int, const int,
+        int *, int *, int *);
+static void GatherPencil(const int, const int, const int, Real *const [restrict],
+        Real [restrict][DIMU]);
+static void GatherCache(const int, const int, const int, Real *const [restrict],
+        Real [restrict][DIMUc]);
+static void SolveOperator(const int, const int, const int, const Real, const Real,
+        const int, const int, const Real [restrict], Field *const, const Real,
         const Real [restrict]);
 /****************************************************************************
  * Global Variables Definition with Private Scope
  ****************************************************************************/
-static TimeIntegrator IntegrateTime[2] = {
+static TimeIntegrator IntegrateTime[3] = {
     RungeKutta2,
-    RungeKutta3};
+    RungeKutta3,
+    RungeKutta3LS};
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -51,9 +61,19 @@ static TimeIntegrator IntegrateTime[2] = {
  * Multi-dimensionality is addressed by two approaches
  *   a) - operator splitting
  *   b) - operator-by-operator approximation
+ *   c) - operator splitting with alternating sweep order
+ * The symmetric splitting of a) takes two half-step sweeps per direction in
+ * every step. c) instead takes one full-step sweep per direction in reversed
+ * order on every other step. Only when two adjacent steps share the same dt
+ * and no solid dynamics update the geometry in between do they form the
+ * symmetric splitting Z Y X X Y Z. In general, c) is first order Lie
+ * splitting per step. A full-step sweep doubles the Courant number of a
+ * half-step sweep, hence the time step is halved for c).
  */
-void EvolveFluidDynamics(const Real dt, Space *space, const Model *model)
+void EvolveFluidDynamics(const int stepC, const Real dt, Space *space, const Model *model)
 {
+    int sweep[DIMS] = {Z, Y, X}; /* sweep directions of alternating operator splitting */
+    int sweepN = DIMS; /* number of sweep directions */
     if (0 != model->sState) {
         DiscretizeTime(0.5 * dt, PHI, space, model);
     }
@@ -106,6 +126,12 @@ void EvolveFluidDynamics(const Real dt, Space *space, const Model *model)
             DiscretizeTime(0.5 * dt, DIMS, space, model);
             DiscretizeTime(0.5 * dt, DIMS, space, model);
             break;
+        case OPTSTRANG:
+            sweepN = SweepOrder(space->part.collapse, sweep);
+            for (int n = 0; n < sweepN; ++n) { /* Z Y X on odd steps, X Y Z on even steps */
+                DiscretizeTime(dt, sweep[(0 != stepC % 2) ? n : (sweepN - 1 - n)], space, model);
+            }
+            break;
         default:
             break;
     }
@@ -114,6 +140,37 @@ void EvolveFluidDynamics(const Real dt, Space *space, const Model *model)
     }
     return;
 }
+/*
+ * Get the directions that are not collapsed in the order of Z, Y, X.
+ */
+static int SweepOrder(const int collapse, int sweep[restrict])
+{
+    switch (collapse) {
+        case COLLAPSEN:
+            sweep[0] = Z; sweep[1] = Y; sweep[2] = X;
+            return 3;
+        case COLLAPSEX:
+            sweep[0] = Z; sweep[1] = Y;
+            return 2;
+        case COLLAPSEY:
+            sweep[0] = Z; sweep[1] = X;
+            return 2;
+        case COLLAPSEZ:
+            sweep[0] = Y; sweep[1] = X;
+            return 2;
+        case COLLAPSEXY:
+            sweep[0] = Z;
+            return 1;
+        case COLLAPSEXZ:
+            sweep[0] = Y;
+            return 1;
+        case COLLAPSEYZ:
+            sweep[0] = X;
+            return 1;
+        default:
+            return 0;
+    }
+}
 /*
  * dU/dt = LU
  * Computation must start from TO data space and end with TO data space.
@@ -146,9 +203,78 @@ static void RungeKutta3(const Real dt, const int s, Space *space, const Model *m
     TreatBoundary(TO, space, model);
     return;
 }
+/*
+ * Third order SSP Runge-Kutta scheme in the 2N-storage form of Williamson,
+ * which only keeps the solution Un in TO and the increment dU in TN. Its
+ * SSP coefficient is 0.32, smaller than the 1.0 of RungeKutta3, in return
+ * for one time level less. The time step is scaled by this ratio.
+ *
+ * Ketcheson, D.I., 2008. Highly efficient strong stability-preserving
+ * Runge-Kutta methods with low-storage implementations. SIAM Journal on
+ * Scientific Computing, 30(4), pp.2113-2136.
+ */
+static void RungeKutta3LS(const Real dt, const int s, Space *space, const Model *model)
+{
+    const Real A[3] = {0.0, -2.915492524638791, -0.000000093517376};
+    const Real B[3] = {0.924574000000000, 0.287713063186749, 0.626538109512740};
+    for (int n = 0; n < 3; ++n) {
+        /* solve dU = A * dU + dt * LUn */
+        LLLU(dt, A[n], 1.0, NONE, TO, TN, s, space, model);
+        /* solve Un = Un + B * dU */
+        UpdateRegister(B[n], TN, TO, space, model);
+        TreatBoundary(TO, space, model);
+    }
+    return;
+}
+/*
+ * Um = Um + coe * Un at the nodes solved by LLLU. As in LLLU, the maximum
+ * characteristic speeds are reduced along when the solution level is written.
+ */
+static void UpdateRegister(const Real coe, const int tn, const int tm, Space *space,
+        const Model *model)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
+    const int fuse = (TO == tm);
+    RealVec Vmax = {0.0}; /* maximum characteristic speeds */
+    if (tm == field->tc) { /* cached primitives become outdated */
+        field->tc = NONE;
+    }
+    if (fuse) {
+        field->tv = NONE;
+    }
+#pragma omp parallel for collapse(2) schedule(static) reduction(max:Vmax[:DIMS])
+    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+            Real Uo[DIMUo] = {0.0};
+            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                if (0 != field->did[idx]) {
+                    continue;
+                }
+                for (int n = 0; n < DIMU; ++n) {
+                    field->U[tm][n][idx] = field->U[tm][n][idx] + coe * field->U[tn][n][idx];
+                }
+                if (fuse) {
+                    LoadPrimitive(TO, idx, field, model, Uo);
+                    MaxCharacteristicSpeed(model->gamma, model->gasR, Uo, Vmax);
+                }
+            }
+        }
+    }
+    if (fuse) {
+        for (int s = 0; s < DIMS; ++s) {
+            field->vmax[s] = Vmax[s];
+        }
+        field->tv = TO;
+    }
+    return;
+}
 /*
  * Spatial operator computation.
  * LLLU = coeA * Un + coeB * LLU; LLU = (I + dt*L)U; L = {Ls, phi}; s = X, Y, Z.
+ * If to is NONE, the increment form of 2N-storage schemes is solved instead,
+ * LLLU = coeA * Um + coeB * dt*LU, where Um is the increment held by tm.
  * Strategy for general coding: use p as operator identifier, use general
  * algorithms and function pointers to unify the function and code for each
  * value of p. If a function is too difficult to do general coding, then code
@@ -158,85 +284,190 @@ static void LLLU(const Real dt, const Real coeA, const Real coeB, const int to,
         const int tn, const int tm, const int p, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    int idx = 0; /* linear array index math variable */
-    int i = 0, j = 0, k = 0; /* index with normal order */
-    const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
-    Real RHS[5][DIMU] = {{0.0}}; /* spatial operator */
-    Real *restrict FhatR = RHS[0]; /* reconstructed numerical convective flux vector */
-    Real *restrict FhatL = RHS[1]; /* reconstructed numerical convective flux vector */
-    Real *restrict FvhatR = RHS[2]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict FvhatL = RHS[3]; /* reconstructed numerical diffusive flux vector */
-    Real *restrict Phi = RHS[4]; /* right hand side vector */
-    Real *temp = NULL;
+    Field *const field = &(space->field);
     const IntVec partn = {part->n[X], part->n[Y], part->n[Z]};
+    const IntVec stride = {1, partn[X], partn[X] * partn[Y]}; /* index stride of each direction */
     const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const RealVec r = {dt * dd[X], dt * dd[Y], dt * dd[Z]};
-    int s = 0, sN = 0; /* space sweep control for the operator p */
+    const int lineN = MaxInt(partn[X], MaxInt(partn[Y], partn[Z]));
+    const int viscous = (0.0 < model->refMu); /* otherwise diffusive fluxes stay zero */
+    int sMin = 0, sN = 0; /* space sweep control for the operator p */
     switch (p) {
         case PHI: /* source term */
-            s = 0; sN = s + 1;
+            sMin = 0; sN = sMin + 1;
             break;
         case DIMS: /* all spatial operators */
-            s = 0; sN = DIMS;
+            sMin = 0; sN = DIMS;
             break;
         default: /* individual spatial operator */
-            s = p; sN = s + 1;
+            sMin = p; sN = sMin + 1;
             break;
     }
-    /* space sweep with dimension priority */
-    for (; s < sN; ++s) {
-        for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
-            for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
-                for (int is = part->np[s][X][MIN], state = 0; is < part->np[s][X][MAX]; ++is) {
-                    switch (s) {
-                        case X:
-                            i = is; j = js; k = ks;
-                            break;
-                        case Y:
-                            i = js; j = is; k = ks;
-                            break;
-                        case Z:
-                            i = js; j = ks; k = is;
-                            break;
-                        default:
-                            break;
-                    }
-                    idx = IndexNode(k, j, i, partn[Y], partn[X]);
-                    if (0 != node[idx].did) {
-                        state = 0; /* mark domain change and boundary occurrence */
+    if (tm == field->tc) { /* cached primitives become outdated */
+        field->tc = NONE;
+    }
+    const int cached = (tn == field->tc); /* convective fluxes read the primitive cache */
+    /*
+     * When the solution level is written, the maximum characteristic speeds
+     * of the CFL condition are reduced from the nodes just solved by the last
+     * sweep, which saves the time step computation a pass over the field.
+     */
+    const int fuse = (TO == tm);
+    RealVec Vmax = {0.0}; /* maximum characteristic speeds */
+    if (fuse) {
+        field->tv = NONE;
+    }
+    /*
+     * Grid lines of a sweep are independent of each other, hence they are
+     * distributed among threads with each thread owning its pencils. The
+     * implicit barrier after each sweep keeps the accumulation order of the
+     * operator-by-operator approximation.
+     */
+#pragma omp parallel
+    {
+        int idx = 0; /* linear array index math variable */
+        int i = 0, j = 0, k = 0; /* index with normal order */
+        Real Phi[DIMU] = {0.0}; /* right hand side vector */
+        Real Un[DIMU] = {0.0};
+        Real Uo[DIMUo] = {0.0};
+        RealVec Vn = {0.0}; /* maximum characteristic speeds of nodes solved by the thread */
+        Real (*Up)[DIMU] = AssignStorage(lineN * sizeof(*Up)); /* pencil of conservative vectors */
+        Real (*Pp)[DIMUc] = NULL; /* pencil of cached primitive vectors */
+        if (cached) {
+            Pp = AssignStorage(lineN * sizeof(*Pp));
+        }
+        Real (*Fhat)[DIMU] = AssignStorage(lineN * sizeof(*Fhat)); /* convective flux at m+1/2 */
+        Real (*Fvhat)[DIMU] = AssignStorage(lineN * sizeof(*Fvhat)); /* diffusive flux at m+1/2 */
+        /* space sweep with dimension priority */
+        for (int s = sMin; s < sN; ++s) {
+            const FhatKernel ComputeFhat = SelectFhatKernel(s, model);
+#pragma omp for collapse(2) schedule(static)
+            for (int ks = part->np[s][Z][MIN]; ks < part->np[s][Z][MAX]; ++ks) {
+                for (int js = part->np[s][Y][MIN]; js < part->np[s][Y][MAX]; ++js) {
+                    if (PHI == p) {
+                        for (int is = part->np[s][X][MIN]; is < part->np[s][X][MAX]; ++is) {
+                            MapLineNode(s, ks, js, is, &k, &j, &i);
+                            idx = IndexNode(k, j, i, partn[Y], partn[X]);
+                            if (0 != field->did[idx]) {
+                                continue;
+                            }
+                            ComputePhi(tn, k, j, i, partn, field, model, Phi);
+                            LoadU(idx, field->U[tn], Un);
+                            SolveOperator(OPTSPLIT, s, idx, coeA, coeB, to, tm, Un, field, dt, Phi);
+                            if (fuse) {
+                                LoadPrimitive(TO, idx, field, model, Uo);
+                                MaxCharacteristicSpeed(model->gamma, model->gasR, Uo, Vn);
+                            }
+                        }
                         continue;
                     }
-                    switch (p) {
-                        case PHI:
-                            ComputePhi(tn, k, j, i, partn, node, model, Phi);
-                            SolveOperator(OPTSPLIT, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], dt, Phi);
-                            continue;
-                        default:
-                            break;
+                    /* linear index of the first node of current grid line */
+                    MapLineNode(s, ks, js, 0, &k, &j, &i);
+                    const int idx0 = IndexNode(k, j, i, partn[Y], partn[X]);
+                    GatherPencil(partn[s], idx0, stride[s], field->U[tn], Up);
+                    if (cached) {
+                        GatherCache(partn[s], idx0, stride[s], field->Uc, Pp);
                     }
-                    switch (state) {
-                        case 1: /* inherit numerical flux from the previous node */
-                            temp = FhatL;
-                            FhatL = FhatR;
-                            FhatR = temp;
-                            temp = FvhatL;
-                            FvhatL = FvhatR;
-                            FvhatR = temp;
-                            break;
-                        default: /* compute numerical flux at left interface */
-                            ComputeFhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, node, model, FhatL);
-                            ComputeFvhat(tn, s, k - h[s][Z], j - h[s][Y], i - h[s][X], partn, dd, node, model, FvhatL);
-                            state = 1;
-                            break;
+                    for (int is = part->np[s][X][MIN], ie = 0; is < part->np[s][X][MAX]; is = ie) {
+                        if (0 != field->did[idx0 + is * stride[s]]) {
+                            ie = is + 1; /* domain change and boundary occurrence */
+                            continue;
+                        }
+                        /* find the run of consecutive fluid nodes [is, ie) */
+                        for (ie = is + 1; ie < part->np[s][X][MAX]; ++ie) {
+                            if (0 != field->did[idx0 + ie * stride[s]]) {
+                                break;
+                            }
+                        }
+                        /* fluxes at all the interfaces bounding the run */
+                        ComputeFhat(is - 1, ie, Up, Pp, model, Fhat);
+                        for (int m = is - 1; (viscous) && (m < ie); ++m) {
+                            MapLineNode(s, ks, js, m, &k, &j, &i);
+                            ComputeFvhat(tn, s, k, j, i, partn, dd, field, model, Fvhat[m]);
+                        }
+                        for (int m = is; m < ie; ++m) {
+                            LU(Fhat[m], Fhat[m-1], Fvhat[m], Fvhat[m-1], Phi);
+                            SolveOperator(model->multidim, s, idx0 + m * stride[s], coeA, coeB,
+                                    to, tm, Up[m], field, r[s], Phi);
+                            if (fuse && (sN - 1 == s)) {
+                                LoadPrimitive(TO, idx0 + m * stride[s], field, model, Uo);
+                                MaxCharacteristicSpeed(model->gamma, model->gasR, Uo, Vn);
+                            }
+                        }
                     }
-                    ComputeFhat(tn, s, k, j, i, partn, node, model, FhatR);
-                    ComputeFvhat(tn, s, k, j, i, partn, dd, node, model, FvhatR);
-                    LU(FhatR, FhatL, FvhatR, FvhatL, Phi);
-                    SolveOperator(model->multidim, s, coeA, coeB, node[idx].U[to], node[idx].U[tn], node[idx].U[tm], r[s], Phi);
                 }
             }
         }
+        RetrieveStorage(Up);
+        RetrieveStorage(Pp);
+        RetrieveStorage(Fhat);
+        RetrieveStorage(Fvhat);
+#pragma omp critical
+        for (int s = 0; s < DIMS; ++s) {
+            Vmax[s] = MaxReal(Vmax[s], Vn[s]);
+        }
+    }
+    if (fuse) {
+        for (int s = 0; s < DIMS; ++s) {
+            field->vmax[s] = Vmax[s];
+        }
+        field->tv = TO;
+    }
+    return;
+}
+/*
+ * Map the node indices of a sweep, which are ordered by dimension priority
+ * with is along the sweep direction s, to the normal order.
+ */
+static void MapLineNode(const int s, const int ks, const int js, const int is,
+        int *k, int *j, int *i)
+{
+    switch (s) {
+        case X:
+            *i = is; *j = js; *k = ks;
+            break;
+        case Y:
+            *i = js; *j = is; *k = ks;
+            break;
+        case Z:
+            *i = js; *j = ks; *k = is;
+            break;
+        default:
+            break;
+    }
+    return;
+}
+/*
+ * Gather the conservative vectors of a whole grid line, including its ghost
+ * nodes, into a contiguous pencil. Stencils of the sweep then are read with
+ * unit stride regardless of the direction of the line.
+ */
+static void GatherPencil(const int nL, const int idx0, const int stride,
+        Real *const Uf[restrict], Real Up[restrict][DIMU])
+{
+    for (int n = 0; n < DIMU; ++n) {
+        const Real *restrict U = Uf[n] + idx0;
+        for (int m = 0; m < nL; ++m) {
+            Up[m][n] = U[m * stride];
+        }
+    }
+    return;
+}
+/*
+ * Gather the cached primitives of the same grid line as GatherPencil. Only
+ * the ones read by the convective flux are gathered, rho is in the pencil.
+ */
+static void GatherCache(const int nL, const int idx0, const int stride,
+        Real *const Uc[restrict], Real Pp[restrict][DIMUc])
+{
+    for (int n = 1; n < DIMUc; ++n) {
+        if (4 == n) { /* p */
+            continue;
+        }
+        const Real *restrict P = Uc[n] + idx0;
+        for (int m = 0; m < nL; ++m) {
+            Pp[m][n] = P[m * stride];
+        }
     }
     return;
 }
@@ -250,25 +481,34 @@ static void LU(const Real FhatR[restrict], const Real FhatL[restrict],
 }
 /*
  * Solve the solution operator for time integration.
- * Note: Uo, Un, and Um are all restricted pointers. Under the condition that
- * Un and Um NEVER alias each other, Uo and Un may alias safely since they only
- * read elements and never modify any elements. Uo and Um may alias safely
- * since Uo only fetch the single element that Um modifies later.
+ * Note: time levels tn and tm NEVER coincide, while to may coincide with
+ * either of them. This is safe since each variable of the current node is
+ * read from the to level before the tm level is written. Values of the tn
+ * level are passed in from the pencil, which is never written.
  */
-static void SolveOperator(const int p, const int s, const Real coeA, const Real coeB,
-        const Real Uo[restrict], const Real Un[restrict], Real Um[restrict], const Real r,
+static void SolveOperator(const int p, const int s, const int idx, const Real coeA, const Real coeB,
+        const int to, const int tm, const Real Un[restrict], Field *const field, const Real r,
         const Real Phi[restrict])
 {
+    Real *const *const Um = field->U[tm];
     /* accumulation step for operator-by-operator approximation */
     if ((OPTBYOPT == p) && (X != s)) {
         for (int n = 0; n < DIMU; ++n) {
-            Um[n] = Um[n] + coeB * r * Phi[n];
+            Um[n][idx] = Um[n][idx] + coeB * r * Phi[n];
+        }
+        return;
+    }
+    /* solve step for the increment of 2N-storage schemes */
+    if (NONE == to) {
+        for (int n = 0; n < DIMU; ++n) {
+            Um[n][idx] = coeA * Um[n][idx] + coeB * r * Phi[n];
         }
         return;
     }
     /* solve step for the solution operator */
+    Real *const *const Uo = field->U[to];
     for (int n = 0; n < DIMU; ++n) {
-        Um[n] = coeA * Uo[n] + coeB * (Un[n] + r * Phi[n]);
+        Um[n][idx] = coeA * Uo[n][idx] + coeB * (Un[n] + r * Phi[n]);
     }
     return;
 }
@@ -29,7 +29,7 @@
  * Function
  *      Evolve fluid dynamics.
  */
-extern void EvolveFluidDynamics(const Real dt, Space *, const Model *);
+extern void EvolveFluidDynamics(const int stepC, const Real dt, Space *, const Model *);
 #endif
 /* a good practice: end file with a newline */
 
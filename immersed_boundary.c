@@ -34,19 +34,22 @@ typedef enum {
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
-static void InitializeGeometricField(Space *);
+static int SetRemapRegion(int [restrict][DIMS][LIMIT], Space *);
+static void ExtendNodeBox(const int, int [restrict][LIMIT], const Partition *const);
+static void InitializeGeometricField(const int, int [restrict][DIMS][LIMIT], Space *);
 static void SetDomainField(Space *);
-static void SetInterfacialField(Space *, const Model *);
+static void SetInterfacialField(const int, int [restrict][DIMS][LIMIT], Space *, const Model *);
+static void BuildGhostList(const int, int [restrict][DIMS][LIMIT], Space *, const Model *);
 static int GetInterState(const int, const int, const int, const int, const int,
-        const int, const int [restrict][DIMS], const Node *const, const Partition *const);
+        const int, const int [restrict][DIMS], const Field *const, const Partition *const);
 static void ApplyWeighting(const Real [restrict], const Real, Real,
         Real [restrict], Real [restrict]);
-static Real InverseDistanceWeighting(const int, const int [restrict],
-        const Real [restrict], const int, const int, const int, const Partition *const,
-        const Node *const, const Model *, Real [restrict]);
-static void ReconstructFlow(const int, const int [restrict], const Real [restrict],
-        const int, const int, const int, const Polyhedron *, const Partition *const,
-        const Node *const, const Model *, const Real [restrict], const Real [restrict],
+static void SearchStencil(const int [restrict], const Real [restrict], const int,
+        const int, const int, const Partition *const, const Field *const, Stencil *);
+static Real InverseDistanceWeighting(const int, const int, const int,
+        const Stencil *, const Field *const, const Model *, Real [restrict]);
+static void ReconstructFlow(const int, const Ghost *, const Polyhedron *,
+        const Partition *const, const Field *const, const Model *,
         Real [restrict], Real [restrict]);
 /****************************************************************************
  * Function definitions
@@ -64,47 +67,132 @@ static void ReconstructFlow(const int, const int [restrict], const Real [restric
  */
 void ComputeGeometricField(Space *space, const Model *model)
 {
-    InitializeGeometricField(space);
+    const Partition *const part = &(space->part);
+    Geometry *const geo = &(space->geo);
+    space->field.tv = NONE; /* the set of fluid nodes changes */
+    /* index geometries overlapping the interior nodes and a node beyond */
+    Real region[DIMS][LIMIT] = {{0.0}};
+    for (int s = 0; s < DIMS; ++s) {
+        region[s][MIN] = MapPoint(part->ns[PIN][s][MIN] - 1, part->domain[s][MIN], part->d[s], part->ng[s]);
+        region[s][MAX] = MapPoint(part->ns[PIN][s][MAX], part->domain[s][MIN], part->d[s], part->ng[s]);
+    }
+    BuildCellList(region, geo);
+    int (*rbox)[DIMS][LIMIT] = NULL; /* boxes of remapping region */
+    if (0 < geo->totN) {
+        rbox = AssignStorage(geo->totN * sizeof(*rbox));
+    }
+    const int rboxN = SetRemapRegion(rbox, space);
+    InitializeGeometricField(rboxN, rbox, space);
     SetDomainField(space);
-    SetInterfacialField(space, model);
+    SetInterfacialField(rboxN, rbox, space, model);
+    BuildGhostList(rboxN, rbox, space, model);
+    RetrieveStorage(rbox);
     return;
 }
-static void InitializeGeometricField(Space *space)
+/*
+ * Due to the restricted motion, the domain field can only change in the
+ * bounding boxes of non-stationary polyhedrons at the previous and the
+ * current mapping. Interfacial states additionally depend on gl layers of
+ * neighbours, and stale nodes of a polyhedron may lag behind its previous
+ * bounding box by a node. Therefore, the remapping region of a polyhedron
+ * is the union of the two boxes extended by gl+1 layers, and nodes outside
+ * all remapping regions keep their domain and interfacial states.
+ *
+ * Boxes of different polyhedrons may overlap. Each remapping pass is kept
+ * idempotent to allow visiting a node more than once.
+ */
+static int SetRemapRegion(int rbox[restrict][DIMS][LIMIT], Space *space)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Geometry *const geo = &(space->geo);
+    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
+    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    Polyhedron *poly = NULL;
+    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    int rboxN = 0;
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        for (int s = 0; s < DIMS; ++s) {
+            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
+            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+        }
+        if (1 != poly->state) {
+            for (int s = 0; s < DIMS; ++s) {
+                rbox[rboxN][s][MIN] = box[s][MIN];
+                rbox[rboxN][s][MAX] = box[s][MAX];
+                if (poly->nbox[s][MIN] < poly->nbox[s][MAX]) { /* mapped before */
+                    rbox[rboxN][s][MIN] = MinInt(box[s][MIN], poly->nbox[s][MIN]);
+                    rbox[rboxN][s][MAX] = MaxInt(box[s][MAX], poly->nbox[s][MAX]);
+                }
+            }
+            ExtendNodeBox(part->gl + 1, rbox[rboxN], part);
+            ++rboxN;
+        }
+        memcpy(poly->nbox, box, sizeof(box));
+    }
+    return rboxN;
+}
+static void ExtendNodeBox(const int h, int box[restrict][LIMIT], const Partition *const part)
+{
+    for (int s = 0; s < DIMS; ++s) {
+        box[s][MIN] = MaxInt(box[s][MIN] - h, part->ns[PIN][s][MIN]);
+        box[s][MAX] = MinInt(box[s][MAX] + h, part->ns[PIN][s][MAX]);
+    }
+    return;
+}
+static void InitializeGeometricField(const int rboxN, int rbox[restrict][DIMS][LIMIT], Space *space)
+{
+    const Partition *const part = &(space->part);
+    Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
     int idx = 0; /* linear array index math variable */
     int gid = 0; /* store geometry identifier */
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                gid = node[idx].did;
-                node[idx].gst = node[idx].did; /* preserve domain field */
-                if (0 == gid) {
-                    node[idx].fid = 0; /* remove passe domain change mark */
-                    continue; /* skip non-polyhedron nodes */
-                }
-                /* the rest is to treat polyhedron nodes */
-                poly = geo->poly + gid - 1;
-                if (1 == poly->state) {
-                    continue; /* keep domain field for nodes in stationary polyhedron */
+    /* preserve domain field before any reset */
+    for (int m = 0; m < rboxN; ++m) {
+        for (int k = rbox[m][Z][MIN]; k < rbox[m][Z][MAX]; ++k) {
+            for (int j = rbox[m][Y][MIN]; j < rbox[m][Y][MAX]; ++j) {
+                for (int i = rbox[m][X][MIN]; i < rbox[m][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    field->gst[idx] = field->did[idx];
+                    if (0 == field->did[idx]) {
+                        field->fid[idx] = 0; /* remove passe domain change mark */
+                    }
                 }
-                /*
-                 * The rest is to treat nodes in non-stationary polyhedrons. Due
-                 * to the restricted motion, can only reset interfacial nodes for
-                 * remapping while keeping non-interfacial nodes to reduce cost.
-                 * When polyhedrons move, the previous nth layer may become a
-                 * (n-1)th layer, therefore, need to reset gl+1 layers to
-                 * ensure the closest face id information of all the future
-                 * gl interfacial nodes are updated. However, if only need to
-                 * update the closest face id information for the future gl-1
-                 * layers, can only reset gl interfacial layers.
-                 */
-                if (0 < node[idx].lid) {
-                    node[idx].did = 0;
+            }
+        }
+    }
+    for (int m = 0; m < rboxN; ++m) {
+        for (int k = rbox[m][Z][MIN]; k < rbox[m][Z][MAX]; ++k) {
+            for (int j = rbox[m][Y][MIN]; j < rbox[m][Y][MAX]; ++j) {
+                for (int i = rbox[m][X][MIN]; i < rbox[m][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    gid = field->did[idx];
+                    if (0 == gid) {
+                        continue; /* skip non-polyhedron nodes */
+                    }
+                    /* the rest is to treat polyhedron nodes */
+                    poly = geo->poly + gid - 1;
+                    if (1 == poly->state) {
+                        continue; /* keep domain field for nodes in stationary polyhedron */
+                    }
+                    /*
+                     * The rest is to treat nodes in non-stationary polyhedrons. Due
+                     * to the restricted motion, can only reset interfacial nodes for
+                     * remapping while keeping non-interfacial nodes to reduce cost.
+                     * When polyhedrons move, the previous nth layer may become a
+                     * (n-1)th layer, therefore, need to reset gl+1 layers to
+                     * ensure the closest face id information of all the future
+                     * gl interfacial nodes are updated. However, if only need to
+                     * update the closest face id information for the future gl-1
+                     * layers, can only reset gl interfacial layers.
+                     */
+                    if (0 < field->lid[idx]) {
+                        field->did[idx] = 0;
+                    }
                 }
             }
         }
@@ -120,111 +208,278 @@ static void InitializeGeometricField(Space *space)
  * To best utilize the convergence property of immersed boundary treatment,
  * points either in or on geometry should be classified into the geometry.
  *
- * For a large data set, an extra data preprocessing with spatial subdivision
- * is required to ensure minimal test in addition to the bounding container
- * method. Spatial subdivision is to provide internal resolution for the
- * polyhedron for fast inclusion determination.
+ * For a triangulated polyhedron, nodes are classified row by row with the
+ * scanline ray parity: the surface crossings of the line through a node
+ * row are computed once and nodes between an odd crossing and the next one
+ * are inside. Nodes lying on a crossing, and all nodes of a row whose line
+ * touches an edge or a vertex, are classified by the point-wise test. Face
+ * links of nodes filled by parity are left for the interfacial field to
+ * resolve, since only interfacial nodes require them. When a distance field
+ * is sampled, nodes away from the surface are classified by the field, and
+ * crossings are only computed for rows having nodes near the surface.
  */
 static void SetDomainField(Space *space)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
     const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
     const Polyhedron *poly = NULL;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     int fid = 0; /* store face link */
     int idx = 0; /* linear array index math variable */
     RealVec p = {0.0}; /* node point */
+    int faceN = 0;
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        faceN = (faceN > geo->poly[n].faceN) ? faceN : geo->poly[n].faceN;
+    }
+    Real *xc = NULL; /* surface crossings of a node row */
+    if (0 < faceN) {
+        xc = AssignStorage(faceN * sizeof(*xc));
+    }
+    int crossN = 0; /* number of crossings of a node row */
+    int cm = 0; /* crossings passed by a node */
+    int row = 0; /* crossings of the node row are available */
+    int in = 0; /* inside indicator */
     /* overlapping geometries introduce loop-carried dependence for node mapping */
-    for (int n = 0; n < geo->totN; ++n) {
+    for (int m = 0; m < geo->cl.activeN; ++m) {
+        const int n = geo->cl.active[m];
         poly = geo->poly + n;
         if (1 == poly->state) {
             continue;
         }
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
+        /* search range is the bounding box of polyhedron in valid node space */
+        const int (*const box)[LIMIT] = poly->nbox;
         /* find nodes in geometry, then flag and link to geometry */
         for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
             for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
+                p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
+                row = 0;
+                cm = 0;
                 for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if (0 != node[idx].did) { /* already classified */
+                    if (0 != field->did[idx]) { /* already classified */
                         continue;
                     }
                     p[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    p[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    p[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
                     if (0 >= poly->faceN) { /* analytical polyhedron */
                         if (poly->r * poly->r >= Dist2(poly->O, p)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = 0;
+                            field->did[idx] = n + 1;
+                            field->fid[idx] = 0;
+                        }
+                        continue;
+                    }
+                    /* triangulated polyhedron */
+                    in = PointInDistanceField(p, poly);
+                    if (NONE != in) {
+                        if (in) {
+                            field->did[idx] = n + 1;
+                            field->fid[idx] = NONE;
+                        }
+                        continue;
+                    }
+                    if (!row) { /* crossings are computed once needed */
+                        crossN = ComputeRayCrossing(p, poly, xc);
+                        row = 1;
+                    }
+                    if (0 <= crossN) {
+                        while ((cm < crossN) && (xc[cm] < p[X])) {
+                            ++cm;
                         }
-                    } else { /* triangulated polyhedron */
-                        if (PointInPolyhedron(p, poly, &fid)) {
-                            node[idx].did = n + 1;
-                            node[idx].fid = fid;
+                        if ((cm == crossN) || (xc[cm] != p[X])) { /* not on a crossing */
+                            if (cm % 2) {
+                                field->did[idx] = n + 1;
+                                field->fid[idx] = NONE;
+                            }
+                            continue;
                         }
                     }
+                    if (PointInPolyhedron(p, poly, &fid)) {
+                        field->did[idx] = n + 1;
+                        field->fid[idx] = fid;
+                    }
                 }
             }
         }
     }
+    RetrieveStorage(xc);
     return;
 }
-static void SetInterfacialField(Space *space, const Model *model)
+static void SetInterfacialField(const int rboxN, int rbox[restrict][DIMS][LIMIT],
+        Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
+    const Geometry *const geo = &(space->geo);
     int idx = 0; /* linear array index math variable */
     const int sd = 0; /* solution domain */
     IntVec n = {0}; /* current node */
     RealVec p = {0.0}; /* node point */
+    Real U[DIMU] = {0.0};
     Real Uo[DIMUo] = {0.0};
     Real weightSum = 0.0;
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                /* reconstruct newly joined node for the solution domain */
-                if ((node[idx].gst != node[idx].did) && (sd == node[idx].did)) {
-                    /* a newly joined solution domain node */
-                    n[X] = i; n[Y] = j; n[Z] = k;
-                    p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                    p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                    p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                    weightSum = InverseDistanceWeighting(TO, n, p, R, TYPEF, node[idx].did, part, node, model, Uo);
-                    Normalize(DIMUo, weightSum, Uo);
-                    Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
-                    MapConservative(model->gamma, Uo, node[idx].U[TO]);
-                    node[idx].fid = NONE; /* set domain change mark to avoid reconstruction interference */
+    Stencil sten = {0, 0, NULL, NULL}; /* stencil of a newly joined node */
+    for (int m = 0; m < rboxN; ++m) {
+        for (int k = rbox[m][Z][MIN]; k < rbox[m][Z][MAX]; ++k) {
+            for (int j = rbox[m][Y][MIN]; j < rbox[m][Y][MAX]; ++j) {
+                for (int i = rbox[m][X][MIN]; i < rbox[m][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    /* reconstruct newly joined node for the solution domain */
+                    if ((field->gst[idx] != field->did[idx]) && (sd == field->did[idx])) {
+                        /* a newly joined solution domain node */
+                        n[X] = i; n[Y] = j; n[Z] = k;
+                        p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
+                        p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
+                        p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                        sten.n = 0;
+                        SearchStencil(n, p, R, TYPEF, field->did[idx], part, field, &sten);
+                        weightSum = InverseDistanceWeighting(TO, 0, sten.n, &sten, field, model, Uo);
+                        Normalize(DIMUo, weightSum, Uo);
+                        Uo[0] = Uo[4] / (Uo[5] * model->gasR); /* compute density */
+                        MapConservative(model->gamma, Uo, U);
+                        StoreU(idx, U, field->U[TO]);
+                        field->fid[idx] = NONE; /* set domain change mark to avoid reconstruction interference */
+                    }
+                    /* reset interfacial state */
+                    field->lid[idx] = 0;
+                    field->gst[idx] = 0;
+                    /* search neighbours to determine the current interfacial state */
+                    if (sd == field->did[idx]) { /* skip interfacial nodes for main domain */
+                        continue;
+                    }
+                    field->lid[idx] = GetInterState(INTERL, k, j, i, field->did[idx], part->pathSep[0], part->path, field, part);
+                    if ((0 < field->lid[idx]) && (sd != field->did[idx])) { /* ghost node is a subset of interfacial node */
+                        field->gst[idx] = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, field, part);
+                    }
+                    if ((0 < field->lid[idx]) && (0 > field->fid[idx])) { /* link to the closest face */
+                        p[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
+                        p[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
+                        p[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                        field->fid[idx] = FindClosestFace(p, geo->poly + field->did[idx] - 1);
+                    }
                 }
-                /* reset interfacial state */
-                node[idx].lid = 0;
-                node[idx].gst = 0;
-                /* search neighbours to determine the current interfacial state */
-                if (sd == node[idx].did) { /* skip interfacial nodes for main domain */
-                    continue;
+            }
+        }
+    }
+    RetrieveStorage(sten.idx);
+    RetrieveStorage(sten.w);
+    return;
+}
+/*
+ * Ghost nodes of each polyhedron are gathered into a list ordered by layer
+ * and then by node index, together with their geometric data. Therefore,
+ * treatments and integrations over ghost nodes do not need to scan the
+ * bounding box, and the geometric data are computed once per mapping.
+ *
+ * Interpolation stencils only depend on the mapping, hence they are also
+ * searched once per mapping and reused by every stage until the next one.
+ * Lists of a stationary polyhedron are only rebuilt when a remapping region
+ * reaches its stencils. Without phase interaction, this is once for the
+ * entire computation.
+ */
+static void BuildGhostList(const int rboxN, int rbox[restrict][DIMS][LIMIT],
+        Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    Geometry *const geo = &(space->geo);
+    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
+    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
+    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
+    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    Polyhedron *poly = NULL;
+    int box[DIMS][LIMIT] = {{0}}; /* range box of polyhedron nodes */
+    int idx = 0; /* linear array index math variable */
+    int r = 0; /* layer */
+    /* stationary polyhedrons reached by a remapping region, stencils reach R layers beyond */
+    int *flag = AssignStorage((geo->totN + 1) * sizeof(*flag));
+    int *list = AssignStorage((geo->totN + 1) * sizeof(*list));
+    Real rb[DIMS][LIMIT] = {{0.0}}; /* remapping region in real space */
+    for (int m = 0; m < rboxN; ++m) {
+        for (int s = 0; s < DIMS; ++s) {
+            rb[s][MIN] = MapPoint(rbox[m][s][MIN] - R - part->gl - 2, sMin[s], d[s], ng[s]);
+            rb[s][MAX] = MapPoint(rbox[m][s][MAX] + R + part->gl + 1, sMin[s], d[s], ng[s]);
+        }
+        const int listN = QueryCellList(rb, geo, list);
+        for (int l = 0; l < listN; ++l) {
+            flag[list[l]] = 1;
+        }
+    }
+    RetrieveStorage(list);
+    for (int n = 0; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        if ((1 == poly->state) && (!flag[n])) {
+            continue;
+        }
+        memcpy(box, poly->nbox, sizeof(box));
+        ExtendNodeBox(part->gl + 1, box, part);
+        /* count ghost nodes and interfacial nodes of each layer */
+        memset(poly->gs, 0, PATHSEP * sizeof(*poly->gs));
+        memset(poly->lidN, 0, PATHSEP * sizeof(*poly->lidN));
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    if (n + 1 != field->did[idx]) {
+                        continue;
+                    }
+                    ++(poly->lidN[field->lid[idx]]);
+                    ++(poly->gs[field->gst[idx]]);
                 }
-                node[idx].lid = GetInterState(INTERL, k, j, i, node[idx].did, part->pathSep[0], part->path, node, part);
-                if ((0 < node[idx].lid) && (sd != node[idx].did)) { /* ghost node is a subset of interfacial node */
-                    node[idx].gst = GetInterState(INTERG, k, j, i, sd, part->pathSep[0], part->path, node, part);
+            }
+        }
+        /* convert counts into layer ends and allocate lists */
+        poly->sten.n = 0;
+        poly->gs[0] = 0;
+        for (r = 1; r <= part->gl; ++r) {
+            poly->gs[r] = poly->gs[r - 1] + poly->gs[r];
+        }
+        if (poly->ghostM < poly->gs[part->gl]) {
+            RetrieveStorage(poly->ghost);
+            poly->ghostM = poly->gs[part->gl];
+            poly->ghost = AssignStorage(poly->ghostM * sizeof(*poly->ghost));
+        }
+        /* turn layer ends into insertion positions */
+        for (r = part->gl; r > 0; --r) {
+            poly->gs[r] = poly->gs[r - 1];
+        }
+        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    r = field->gst[idx];
+                    if ((n + 1 != field->did[idx]) || (0 == r)) {
+                        continue;
+                    }
+                    Ghost *const ghost = poly->ghost + poly->gs[r];
+                    ++(poly->gs[r]); /* the insertion position ends as the layer end */
+                    ghost->idx = idx;
+                    ghost->nG[X] = i; ghost->nG[Y] = j; ghost->nG[Z] = k;
+                    ghost->pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
+                    ghost->pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
+                    ghost->pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
+                    ComputeGeometricData(ghost->pG, field->fid[idx], poly, ghost->pO, ghost->pI, ghost->N);
+                    ghost->nI[X] = MapNode(ghost->pI[X], sMin[X], dd[X], ng[X]);
+                    ghost->nI[Y] = MapNode(ghost->pI[Y], sMin[Y], dd[Y], ng[Y]);
+                    ghost->nI[Z] = MapNode(ghost->pI[Z], sMin[Z], dd[Z], ng[Z]);
+                    ghost->sm = poly->sten.n;
+                    if (model->ibmLayer >= r) { /* stencil of image point */
+                        SearchStencil(ghost->nI, ghost->pI, R, TYPED, 0, part, field, &(poly->sten));
+                    } else { /* stencil of ghost point */
+                        SearchStencil(ghost->nG, ghost->pG, 1, r - 1, n + 1, part, field, &(poly->sten));
+                    }
+                    ghost->sn = poly->sten.n;
                 }
             }
         }
     }
+    RetrieveStorage(flag);
     return;
 }
 static int GetInterState(const int sid, const int k, const int j, const int i, const int did,
-        const int end, const int path[restrict][DIMS], const Node *const node, const Partition *const part)
+        const int end, const int path[restrict][DIMS], const Field *const field, const Partition *const part)
 {
     /* search around the specified node to check interfacial state */
     int idx = 0; /* linear array index math variable */
@@ -240,12 +495,12 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
         switch (sid) {
             case INTERL:
-                if (did != node[idx].did) { /* a heterogeneous node on the path */
+                if (did != field->did[idx]) { /* a heterogeneous node on the path */
                     flag = 1;
                 }
                 break;
             case INTERG:
-                if (did == node[idx].did) { /* a computational node on the path */
+                if (did == field->did[idx]) { /* a computational node on the path */
                     flag = 1;
                 }
                 break;
@@ -270,74 +525,71 @@ static int GetInterState(const int sid, const int k, const int j, const int i, c
 void TreatImmersedBoundary(const int tn, Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    const Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
-    IntVec nI = {0}; /* image node */
-    IntVec nG = {0}; /* ghost node */
-    RealVec pG = {0.0}; /* ghost point */
-    RealVec pO = {0.0}; /* boundary point */
-    RealVec pI = {0.0}; /* image point */
-    RealVec N = {0.0}; /* normal */
-    Real UoG[DIMUo] = {0.0};
-    Real UoO[DIMUo] = {0.0};
-    Real UoI[DIMUo] = {0.0};
-    Real weightSum = 0.0;
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
-    for (int n = 0; n < geo->totN; ++n) {
-        poly = geo->poly + n;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+    const CellList *const cl = &(geo->cl);
+    if (tn == field->tc) { /* cached primitives become outdated */
+        field->tc = NONE;
+    }
+    /* ghost nodes of a layer of all indexed polyhedrons form one work list */
+    int *gsum = AssignStorage((cl->activeN + 1) * sizeof(*gsum));
+    for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
+        for (int m = 0; m < cl->activeN; ++m) {
+            const Polyhedron *const poly = geo->poly + cl->active[m];
+            gsum[m + 1] = gsum[m] + poly->gs[r] - poly->gs[r - 1];
         }
-        /* treat ghost nodes */
-        for (int r = 1; r <= part->gl; ++r) { /* layer by layer treatment */
-            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                        if ((r != node[idx].gst) || (n + 1 != node[idx].did)) {
-                            continue;
-                        }
-                        pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                        pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                        pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                        if (model->ibmLayer >= r) { /* immersed boundary treatment */
-                            ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                            nI[X] = MapNode(pI[X], sMin[X], dd[X], ng[X]);
-                            nI[Y] = MapNode(pI[Y], sMin[Y], dd[Y], ng[Y]);
-                            nI[Z] = MapNode(pI[Z], sMin[Z], dd[Z], ng[Z]);
-                            /*
-                             * When extremely strong discontinuities exist in the
-                             * domain of dependence of inverse distance weighting,
-                             * WENO's idea may be adopted to avoid discontinuous
-                             * stencils and to only use smooth stencils. However,
-                             * the algorithm will be too complex.
-                             */
-                            ReconstructFlow(tn, nI, pI, R, TYPED, 0, poly, part, node, model, pO, N, UoO, UoI);
-                            DoMethodOfImage(UoI, UoO, UoG);
-                        } else { /* inverse distance weighting */
-                            nG[X] = i; nG[Y] = j; nG[Z] = k;
-                            weightSum = InverseDistanceWeighting(tn, nG, pG, 1, r - 1, n + 1, part, node, model, UoG);
-                            Normalize(DIMUo, weightSum, UoG);
-                        }
-                        UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
-                        MapConservative(model->gamma, UoG, node[idx].U[tn]);
-                    }
-                }
+        /*
+         * Treat ghost nodes. Ghost nodes of a layer are reconstructed only
+         * from fluid nodes and ghost nodes of inner layers of the same
+         * polyhedron, hence nodes of the same layer are treated
+         * independently by threads.
+         */
+#pragma omp parallel for schedule(dynamic)
+        for (int g = 0; g < gsum[cl->activeN]; ++g) {
+            const int m = LocateGhost(g, cl->activeN, gsum);
+            const Polyhedron *const poly = geo->poly + cl->active[m];
+            const Ghost *const ghost = poly->ghost + poly->gs[r - 1] + g - gsum[m];
+            Real U[DIMU] = {0.0};
+            Real UoG[DIMUo] = {0.0};
+            Real UoO[DIMUo] = {0.0};
+            Real UoI[DIMUo] = {0.0};
+            Real weightSum = 0.0;
+            if (model->ibmLayer >= r) { /* immersed boundary treatment */
+                /*
+                 * When extremely strong discontinuities exist in the
+                 * domain of dependence of inverse distance weighting,
+                 * WENO's idea may be adopted to avoid discontinuous
+                 * stencils and to only use smooth stencils. However,
+                 * the algorithm will be too complex.
+                 */
+                ReconstructFlow(tn, ghost, poly, part, field, model, UoO, UoI);
+                DoMethodOfImage(UoI, UoO, UoG);
+            } else { /* inverse distance weighting */
+                weightSum = InverseDistanceWeighting(tn, ghost->sm, ghost->sn, &(poly->sten), field, model, UoG);
+                Normalize(DIMUo, weightSum, UoG);
             }
+            UoG[0] = UoG[4] / (UoG[5] * model->gasR); /* compute density */
+            MapConservative(model->gamma, UoG, U);
+            StoreU(ghost->idx, U, field->U[tn]);
         }
     }
+    RetrieveStorage(gsum);
     return;
 }
+int LocateGhost(const int g, const int n, const int gsum[restrict])
+{
+    int i = 0;
+    int j = n - 1;
+    while (i < j) {
+        const int k = (i + j + 1) / 2;
+        if (gsum[k] <= g) {
+            i = k;
+        } else {
+            j = k - 1;
+        }
+    }
+    return i;
+}
 void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real UoG[restrict])
 {
     /*
@@ -354,15 +606,17 @@ void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real Uo
     UoG[5] = UoI[5];
     return;
 }
-static void ReconstructFlow(const int tn, const int n[restrict], const Real p[restrict],
-        const int h, const int type, const int did, const Polyhedron *poly, const Partition *const part,
-        const Node *const node, const Model *model, const Real pO[restrict], const Real N[restrict],
+static void ReconstructFlow(const int tn, const Ghost *ghost, const Polyhedron *poly,
+        const Partition *const part, const Field *const field, const Model *model,
         Real UoO[restrict], Real Uo[restrict])
 {
     const Real zero = 0.0;
     const Real one = 1.0;
+    const Real *const p = ghost->pI;
+    const Real *const pO = ghost->pO;
+    const Real *const N = ghost->N;
     /* pre-estimate step */
-    Real weightSum = InverseDistanceWeighting(tn, n, p, h, type, did, part, node, model, Uo);
+    Real weightSum = InverseDistanceWeighting(tn, ghost->sm, ghost->sn, &(poly->sten), field, model, Uo);
     const Real weight = one / weightSum;
     /* physical boundary condition enforcement step */
     RealVec Vs = {zero}; /* general motion of boundary point */
@@ -410,19 +664,21 @@ static void ReconstructFlow(const int tn, const int n[restrict], const Real p[re
     Normalize(DIMUo, weightSum, Uo);
     return;
 }
-static Real InverseDistanceWeighting(const int tn, const int n[restrict], const Real p[restrict],
-        const int h, const int type, const int did, const Partition *const part,
-        const Node *const node, const Model *model, Real Uo[restrict])
+/*
+ * Stencil nodes are appended to the stencil with their inverse distance
+ * weights, which only depend on the geometric field.
+ */
+static void SearchStencil(const int n[restrict], const Real p[restrict], const int h,
+        const int type, const int did, const Partition *const part,
+        const Field *const field, Stencil *sten)
 {
     int idx = 0; /* linear array index math variable */
     const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
-    Real Uoh[DIMUo] = {0.0}; /* primitive at neighbouring node */
     RealVec ph = {0.0}; /* neighbouring point */
     IntVec nh = {0}; /* neighbouring node */
-    Real weightSum = 0.0;
-    memset(Uo, 0, DIMUo * sizeof(*Uo));
+    Real weight = 0.0;
     /*
      * Search nodes with required "type" in the domain specified by the center node
      * "n" and initial range "h" as interpolation stencils for the interpolated point "p".
@@ -442,19 +698,19 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     }
                     idx = IndexNode(nh[Z], nh[Y], nh[X], part->n[Y], part->n[X]);
                     /* be aware of the validity of ih = jh = kh = 0 */
-                    if (did != node[idx].did) {
+                    if (did != field->did[idx]) {
                         continue; /* skip node not in target domain */
                     }
                     switch (type) {
                         case TYPED: /* use node in target domain */
                             break;
                         case TYPEF: /* use original node in target domain to avoid priority */
-                            if ((did != node[idx].gst) || (0 > node[idx].fid)) {
+                            if ((did != field->gst[idx]) || (0 > field->fid[idx])) {
                                 continue; /* skip changed node either reconstructed or not */
                             }
                             break;
                         default: /* use node in target domain layer */
-                            if (type != node[idx].gst) {
+                            if (type != field->gst[idx]) {
                                 continue;
                             }
                             break;
@@ -463,12 +719,42 @@ static Real InverseDistanceWeighting(const int tn, const int n[restrict], const
                     ph[X] = MapPoint(nh[X], sMin[X], d[X], ng[X]);
                     ph[Y] = MapPoint(nh[Y], sMin[Y], d[Y], ng[Y]);
                     ph[Z] = MapPoint(nh[Z], sMin[Z], d[Z], ng[Z]);
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[tn], Uoh);
-                    ApplyWeighting(Uoh, part->tinyL, Dist2(p, ph), &weightSum, Uo);
+                    weight = Dist2(p, ph);
+                    if (part->tinyL > weight) { /* avoid overflow of too small weight */
+                        weight = part->tinyL;
+                    }
+                    if (sten->m == sten->n) { /* expand stencil storage */
+                        sten->m = 2 * sten->m + 64;
+                        sten->idx = realloc(sten->idx, sten->m * sizeof(*sten->idx));
+                        sten->w = realloc(sten->w, sten->m * sizeof(*sten->w));
+                        if ((NULL == sten->idx) || (NULL == sten->w)) {
+                            ShowError("memory allocation failed");
+                        }
+                    }
+                    sten->idx[sten->n] = idx;
+                    sten->w[sten->n] = 1.0 / weight;
+                    ++(sten->n);
                 }
             }
         }
     }
+    return;
+}
+static Real InverseDistanceWeighting(const int tn, const int sm, const int sn,
+        const Stencil *sten, const Field *const field, const Model *model, Real Uo[restrict])
+{
+    Real U[DIMU] = {0.0}; /* conservative at neighbouring node */
+    Real Uoh[DIMUo] = {0.0}; /* primitive at neighbouring node */
+    Real weightSum = 0.0;
+    memset(Uo, 0, DIMUo * sizeof(*Uo));
+    for (int m = sm; m < sn; ++m) {
+        LoadU(sten->idx[m], field->U[tn], U);
+        MapPrimitive(model->gamma, model->gasR, U, Uoh);
+        for (int n = 0; n < DIMUo; ++n) {
+            Uo[n] = Uo[n] + Uoh[n] * sten->w[m];
+        }
+        weightSum = weightSum + sten->w[m]; /* accumulate normalizer */
+    }
     return weightSum;
 }
 static void ApplyWeighting(const Real Uoh[restrict], const Real tiny, Real weight,
@@ -27,7 +27,8 @@
  * Compute geometric field
  *
  * Function
- *      Employ a multidomain node mapping algorithm to map the geometry set.
+ *      Employ a multidomain node mapping algorithm to map the geometry set,
+ *      then gather the ghost nodes of each geometry with their geometric data.
  */
 extern void ComputeGeometricField(Space *, const Model *);
 /*
@@ -38,6 +39,14 @@ extern void ComputeGeometricField(Space *, const Model *);
  */
 extern void TreatImmersedBoundary(const int tn, Space *, const Model *);
 extern void DoMethodOfImage(const Real UoI[restrict], const Real UoO[restrict], Real UoG[restrict]);
+/*
+ * Ghost work list
+ *
+ * Function
+ *      Locate the entry of a work list containing the gth ghost node, where
+ *      gsum holds the ascending starts of the n entries.
+ */
+extern int LocateGhost(const int g, const int n, const int gsum[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
@@ -68,33 +68,40 @@ static void InitializeSpaceData(Space *space, const Model *model)
 static void InitializeFieldData(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
+    Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
     RealVec pc = {0.0}; /* coordinates of current node */
     int idx = 0; /* linear array index math variable */
     for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
         for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
             for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                node[idx].did = NONE;
-                node[idx].fid = NONE;
-                node[idx].lid = NONE;
-                node[idx].gst = NONE;
-                memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                field->did[idx] = NONE;
+                field->fid[idx] = NONE;
+                field->lid[idx] = NONE;
+                field->gst[idx] = NONE;
+                for (int tn = 0; tn < field->tl; ++tn) {
+                    for (int n = 0; n < DIMU; ++n) {
+                        memset(field->U[tn][n] + idx, 1, sizeof(Real));
+                    }
+                }
                 if (!InPartBox(k, j, i, part->ns[PIN])) {
                     continue;
                 }
                 /* geometric field initializer */
-                node[idx].did = 0;
-                node[idx].fid = 0;
-                node[idx].lid = 0;
-                node[idx].gst = 0;
+                field->did[idx] = 0;
+                field->fid[idx] = 0;
+                field->lid[idx] = 0;
+                field->gst[idx] = 0;
                 /* data field initializer */
                 pc[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
                 pc[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
                 pc[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
+                LoadU(idx, field->U[TO], U);
                 for (int n = 0; n < part->nIC; ++n) {
-                    ApplyInitializer(n, pc, node[idx].U[TO], part, model);
+                    ApplyInitializer(n, pc, U, part, model);
                 }
+                StoreU(idx, U, field->U[TO]);
             }
         }
     }
@@ -160,13 +167,26 @@ static void ApplyInitializer(const int n, const Real pc[restrict], Real U[restri
     }
     return;
 }
+/*
+ * Polyhedrons imported from the same file with the same scale share one
+ * mesh, and the rest of their transforms only sets the pose. Hence meshes
+ * are processed after all the data are read.
+ */
 static void InitializeGeometryData(Geometry *const geo)
 {
     FILE *fp = Fopen("artracfd.geo", "r");
     const char *fmtI = ParseFormat("%lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg, %lg");
+    const Real one = 1.0;
+    const Real zero = 0.0;
+    String *fname = AssignStorage((geo->totN + 1) * sizeof(*fname)); /* store the file names */
+    Real (*tf)[4][DIMS] = AssignStorage((geo->totN + 1) * sizeof(*tf)); /* scale, angle, offset, centre */
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        tf[n][0][X] = one;
+        tf[n][0][Y] = one;
+        tf[n][0][Z] = one;
+    }
     /* read and process file line by line */
     String str = {'\0'}; /* store the current read line */
-    String fname = {'\0'}; /* store the file name */
     while (NULL != fgets(str, sizeof str, fp)) {
         ParseCommand(str);
         if (0 == strncmp(str, "sphere state begin", sizeof str)) {
@@ -175,9 +195,7 @@ static void InitializeGeometryData(Geometry *const geo)
         }
         if (0 == strncmp(str, "polyhedron geometry begin", sizeof str)) {
             for (int n = geo->sphN; n < geo->totN; ++n) {
-                Sread(fp, 1, "%s", fname);
-                ReadStlFile(fname, geo->poly + n);
-                ConvertPolyhedron(geo->poly + n);
+                Sread(fp, 1, "%s", fname[n]);
             }
             continue;
         }
@@ -186,25 +204,61 @@ static void InitializeGeometryData(Geometry *const geo)
             continue;
         }
         if (0 == strncmp(str, "polyhedron transform begin", sizeof str)) {
-            const Real one = 1.0;
-            const Real zero = 0.0;
-            RealVec scale = {zero};
-            RealVec angle = {zero};
-            RealVec offset = {zero};
             for (int n = geo->sphN; n < geo->totN; ++n) {
-                Sread(fp, 9, fmtI, scale + X, scale + Y, scale + Z,
-                        angle + X, angle + Y, angle + Z, offset + X, offset + Y, offset + Z);
-                if ((one == scale[X]) && (one == scale[Y]) && (one == scale[Z]) &&
-                        (zero == angle[X]) && (zero == angle[Y]) && (zero == angle[Z]) &&
-                        (zero == offset[X]) && (zero == offset[Y]) && (zero == offset[Z])) {
-                    continue;
-                }
-                TransformPolyhedron(geo->poly[n].O, scale, angle, offset, geo->poly + n);
+                Sread(fp, 9, fmtI, tf[n][0] + X, tf[n][0] + Y, tf[n][0] + Z,
+                        tf[n][1] + X, tf[n][1] + Y, tf[n][1] + Z, tf[n][2] + X, tf[n][2] + Y, tf[n][2] + Z);
             }
             continue;
         }
     }
     fclose(fp);
+    /* transforms are about the centres given by states, which the pose overrides */
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        memcpy(tf[n][3], geo->poly[n].O, sizeof(tf[n][3]));
+    }
+    /* import or share meshes, scaling is applied to meshes */
+    const RealVec unit = {one, one, one};
+    const RealVec null = {zero, zero, zero};
+    Polyhedron *poly = NULL;
+    int meshN = 0;
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        poly = geo->poly + n;
+        const Real *const scale = tf[n][0];
+        int m = geo->sphN;
+        while ((m < n) && ((0 != strncmp(fname[m], fname[n], sizeof(String))) ||
+                    (scale[X] != tf[m][0][X]) || (scale[Y] != tf[m][0][Y]) || (scale[Z] != tf[m][0][Z]))) {
+            ++m;
+        }
+        if (m < n) {
+            SharePolyhedronMesh(m + 1, geo->poly + m, poly);
+            /* the shared mesh was scaled about the centre of its owner */
+            for (int s = 0; s < DIMS; ++s) {
+                poly->D[s] = (one - scale[s]) * (tf[n][3][s] - tf[m][3][s]);
+            }
+            continue;
+        }
+        ReadStlFile(fname[n], poly);
+        ConvertPolyhedron(geo->weld, poly);
+        ++meshN;
+        if ((one != scale[X]) || (one != scale[Y]) || (one != scale[Z])) {
+            TransformPolyhedron(tf[n][3], scale, null, null, poly);
+        }
+    }
+    if (meshN < geo->totN - geo->sphN) {
+        ShowInfo("  polyhedron meshes: %d, shared by %d polyhedrons\n", meshN, geo->totN - geo->sphN);
+    }
+    /* rigid transformation only sets the pose */
+    for (int n = geo->sphN; n < geo->totN; ++n) {
+        const Real *const angle = tf[n][1];
+        const Real *const offset = tf[n][2];
+        if ((zero == angle[X]) && (zero == angle[Y]) && (zero == angle[Z]) &&
+                (zero == offset[X]) && (zero == offset[Y]) && (zero == offset[Z])) {
+            continue;
+        }
+        TransformPolyhedron(tf[n][3], unit, angle, offset, geo->poly + n);
+    }
+    RetrieveStorage(fname);
+    RetrieveStorage(tf);
     return;
 }
 static void WritePolyMassProperty(const Geometry *const geo)
@@ -32,9 +32,9 @@ void ComputeSolutionError(Space *space)
 {
     FILE *fp = Fopen("solution_error.csv", "w");
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict Us = NULL; /* numerical solution */
-    Real *restrict Ue = NULL; /* exact solution */
+    const Field *const field = &(space->field);
+    const Real *restrict Us = field->U[TO][0]; /* numerical solution */
+    const Real *restrict Ue = field->U[TN][0]; /* exact solution */
     int idx = 0; /* linear array index math variable */
     const int meshN = MaxInt(part->m[X], MaxInt(part->m[Y], part->m[Z]));
     Real norm[3] = {0.0}; /* Lp norms */
@@ -44,9 +44,7 @@ void ComputeSolutionError(Space *space)
         for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
             for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                Us = node[idx].U[TO];
-                Ue = node[idx].U[TN];
-                err = fabs(Us[0] - Ue[0]);
+                err = fabs(Us[idx] - Ue[idx]);
                 norm[0] = MaxReal(norm[0], err);
                 norm[1] = norm[1] + err;
                 norm[2] = norm[2] + err * err;
@@ -68,8 +66,8 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
         fprintf(fp, "# time, kinetic energy, enstrophy \n");
     }
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL; /* numerical solution */
+    const Field *const field = &(space->field);
+    Real U[DIMU] = {0.0}; /* numerical solution */
     int idx = 0; /* linear array index math variable */
     const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
     const int h[DIMS][DIMS] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; /* direction indicator */
@@ -87,7 +85,7 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
                 for (int s = 0; s < DIMS; ++s) {
                     for (int n = -TCN; n <= TCN; ++n) {
                         idx = IndexNode(k + n * h[s][Z], j + n * h[s][Y], i + n * h[s][X], part->n[Y], part->n[X]);
-                        U = node[idx].U[TO];
+                        LoadU(idx, field->U[TO], U);
                         Vs[X][TCN+n] = U[1] / U[0];
                         Vs[Y][TCN+n] = U[2] / U[0];
                         Vs[Z][TCN+n] = U[3] / U[0];
@@ -97,7 +95,7 @@ void ComputeSolutionFunctional(const Time *time, Space *space, const Model *mode
                     dV[Z][s] = (-Vs[Z][TCN+2] + 8.0 * Vs[Z][TCN+1] - 8.0 * Vs[Z][TCN-1] + Vs[Z][TCN-2]) / (12.0 * d[s]);
                 }
                 idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
+                LoadU(idx, field->U[TO], U);
                 rho = U[0];
                 V[X] = U[1] / U[0];
                 V[Y] = U[2] / U[0];
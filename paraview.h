@@ -16,6 +16,7 @@
 /****************************************************************************
  * Required Header Files
  ****************************************************************************/
+#include <stdint.h> /* fixed width integer types */
 #include "commons.h"
 /****************************************************************************
  * Data Structure Declarations
@@ -25,9 +26,12 @@ typedef enum {
     PVVARSTR = 10, /* variable name length */
     PVSCAN = 10, /* maximum number of scalar variables */
     PVVECN = 1, /* maximum number of vector variables */
+    PVASCII = 0, /* ascii data encoding */
+    PVBINARY = 1, /* raw binary appended data encoding */
 } PvConst;
 typedef char PvStr[PVSTR]; /* string data */
 typedef Real PvReal; /* real data */
+typedef uint64_t PvUInt; /* byte count header of appended data */
 typedef struct {
     PvStr rname; /* data file root name */
     PvStr bname; /* data file base name */
@@ -37,6 +41,7 @@ typedef struct {
     PvStr intType; /* int type */
     PvStr floatType; /* float type */
     PvStr byteOrder; /* byte order of data */
+    int encoding; /* data encoding */
     int scaN; /* number of scalar variables */
     char sca[PVSCAN][PVVARSTR]; /* scalar variables */
     int vecN; /* number of vector variables */
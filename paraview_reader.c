@@ -36,7 +36,7 @@ void ReadStructuredDataParaview(Time *time, Space *space, const Model *model)
         .rname = "field",
         .bname = {'\0'},
         .fname = {'\0'},
-        .fext = ".vts",
+        .fext = ".vti",
         .fmt = "%s%05d",
         .intType = "Int32",
         .floatType = "Float32",
@@ -61,44 +61,86 @@ static void ReadCaseFile(Time *time, PvSet *pvSet)
     fclose(fp);
     return;
 }
+/*
+ * The encoding is identified by the first data array. Binary data are
+ * read array by array from the appended section, in which the required
+ * scalars are stored first and in order.
+ */
 static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
 {
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
-    FILE *fp = Fopen(pvSet->fname, "r");
+    FILE *fp = Fopen(pvSet->fname, "rb");
     PvReal data = 0.0; /* paraview scalar data */
     const char *fmtI = ParseFormat("%lg");
     const Partition *const part = &(space->part);
-    Node *const node = space->node;
-    Real *restrict U = NULL;
+    Field *const field = &(space->field);
+    Real U[DIMU] = {0.0};
     int idx = 0; /* linear array index math variable */
+    String str = {'\0'}; /* store the current read line */
+    float *buffer = NULL; /* binary data of an array */
+    size_t m = 0; /* binary data count */
+    const size_t nodeN = (size_t)(part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN]) *
+        (part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN]) * (part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN]);
     /* get rid of redundant lines */
     ReadInLine(fp, "<PointData>");
+    if (NULL == fgets(str, sizeof str, fp)) {
+        ShowError("no data array: %s", pvSet->fname);
+    }
+    pvSet->encoding = (NULL != strstr(str, "format=\"appended\"")) ? PVBINARY : PVASCII;
+    if (PVBINARY == pvSet->encoding) {
+        ReadInLine(fp, "<AppendedData encoding=\"raw\">");
+        int c = 0;
+        while (('_' != c) && (EOF != c)) {
+            c = fgetc(fp);
+        }
+        buffer = AssignStorage(nodeN * sizeof(*buffer));
+    }
     for (int s = 0; s < pvSet->scaN; ++s) {
-        Sread(fp, 0, "");
+        if (PVBINARY == pvSet->encoding) {
+            PvUInt size = 0;
+            if ((1 != fread(&size, sizeof(size), 1, fp)) || (nodeN * sizeof(*buffer) != size) ||
+                    (nodeN != fread(buffer, sizeof(*buffer), nodeN, fp))) {
+                ShowError("corrupted appended data: %s", pvSet->fname);
+            }
+            m = 0;
+        } else {
+            if (0 < s) {
+                Sread(fp, 0, "");
+            }
+        }
         for (int k = part->ns[PAL][Z][MIN]; k < part->ns[PAL][Z][MAX]; ++k) {
             for (int j = part->ns[PAL][Y][MIN]; j < part->ns[PAL][Y][MAX]; ++j) {
                 for (int i = part->ns[PAL][X][MIN]; i < part->ns[PAL][X][MAX]; ++i) {
                     idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
                     if (0 == s) {
                         /* geometric field initializer */
-                        node[idx].did = NONE;
-                        node[idx].fid = NONE;
-                        node[idx].lid = NONE;
-                        node[idx].gst = NONE;
-                        memset(node[idx].U, 1, DIMT * sizeof(*node[idx].U));
+                        field->did[idx] = NONE;
+                        field->fid[idx] = NONE;
+                        field->lid[idx] = NONE;
+                        field->gst[idx] = NONE;
+                        for (int tn = 0; tn < field->tl; ++tn) {
+                            for (int n = 0; n < DIMU; ++n) {
+                                memset(field->U[tn][n] + idx, 1, sizeof(Real));
+                            }
+                        }
                         if (InPartBox(k, j, i, part->ns[PIN])) {
-                            node[idx].did = 0;
-                            node[idx].fid = 0;
-                            node[idx].lid = 0;
-                            node[idx].gst = 0;
+                            field->did[idx] = 0;
+                            field->fid[idx] = 0;
+                            field->lid[idx] = 0;
+                            field->gst[idx] = 0;
                         }
                     }
                     if (!InPartBox(k, j, i, part->ns[PIO])) {
                         continue;
                     }
                     /* data field initializer */
-                    U = node[idx].U[TO];
-                    Fscanf(fp, 1, fmtI, &data);
+                    LoadU(idx, field->U[TO], U);
+                    if (PVBINARY == pvSet->encoding) {
+                        data = buffer[m];
+                        ++m;
+                    } else {
+                        Fscanf(fp, 1, fmtI, &data);
+                    }
                     switch (s) {
                         case 0: /* rho */
                             U[0] = data;
@@ -119,12 +161,16 @@ static void ReadStructuredData(Space *space, const Model *model, PvSet *pvSet)
                         default:
                             break;
                     }
+                    StoreU(idx, U, field->U[TO]);
                 }
             }
         }
-        Sread(fp, 0, ""); /* get rid of the end of line of data */
-        Sread(fp, 0, "");
+        if (PVASCII == pvSet->encoding) {
+            Sread(fp, 0, ""); /* get rid of the end of line of data */
+            Sread(fp, 0, "");
+        }
     }
+    RetrieveStorage(buffer);
     fclose(fp);
     return;
 }
@@ -205,7 +251,6 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 1, "%*s %*s %d", &(poly->faceN));
         Sread(fp, 0, "");
         AllocatePolyhedronMemory(poly->vertN, poly->edgeN, poly->faceN, poly);
-        poly->edgeN = 0; /* reset edge count before applying edge adding */
         Sread(fp, 0, "");
         Sread(fp, 0, "");
         Sread(fp, 0, "");
@@ -228,11 +273,8 @@ static void ReadPolygonPolyData(const int pm, const int pn, Geometry *const geo,
         Sread(fp, 0, "");
         for (int n = 0; n < poly->faceN; ++n) {
             Fscanf(fp, 3, "%d %d %d", &(poly->f[n][0]), &(poly->f[n][1]), &(poly->f[n][2]));
-            AddEdge(poly->f[n][0], poly->f[n][1], n, poly);
-            AddEdge(poly->f[n][1], poly->f[n][2], n, poly);
-            AddEdge(poly->f[n][2], poly->f[n][0], n, poly);
         }
-        QuickSortEdge(poly->edgeN, poly->e);
+        BuildEdgeList(poly);
         ReadInLine(fp, "</Piece>");
     }
     ReadInLine(fp, "<!--");
@@ -15,14 +15,31 @@
 #include <stdio.h> /* standard library for input and output */
 #include <string.h> /* manipulating strings */
 #include "data_stream.h"
+#include "computational_geometry.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef enum {
+    PVDATAVEL = PVSCAN, /* data type of velocity vector */
+    PVNODESTR = 48, /* maximum text length of the data of a node */
+} PvWriterConst;
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void InitializeTransientCaseFile(PvSet *);
 static void WriteCaseFile(const Time *, PvSet *);
 static void WriteStructuredData(const Space *, const Model *, PvSet *);
+static void WriteNodeData(FILE *, const int, const Space *, const Model *);
+static int FormatNodeData(const int, const int, const int, const int,
+        const Space *, const Model *, char *);
+static void WriteDataArray(FILE *, const int, const char *, const int, const size_t,
+        size_t *, const Space *, const Model *, const PvSet *);
+static void WriteAppendedData(FILE *, const int, const Space *, const Model *, float *);
+static size_t PackNodeData(const int, const Space *, const Model *, float *);
+static int ComputeNodeData(const int, const int, const int, const int,
+        const Space *, const Model *, PvReal [restrict]);
 static void PointPolyDataWriter(const Time *, const Geometry *const);
 static void WritePointPolyData(const int, const int, const Geometry *const, PvSet *);
 static void PolygonPolyDataWriter(const Time *, const Geometry *const);
@@ -36,11 +53,12 @@ void WriteStructuredDataParaview(const Time *time, const Space *space, const Mod
         .rname = "field",
         .bname = {'\0'},
         .fname = {'\0'},
-        .fext = ".vts",
+        .fext = ".vti",
         .fmt = "%s%05d",
         .intType = "Int32",
         .floatType = "Float32",
         .byteOrder = "LittleEndian",
+        .encoding = time->dataFormat,
         .scaN = 10,
         .sca = {"rho", "u", "v", "w", "p", "T", "did", "fid", "lid", "gst"},
         .vecN = 1,
@@ -95,113 +113,230 @@ static void WriteCaseFile(const Time *time, PvSet *pvSet)
     fclose(fp);
     return;
 }
+/*
+ * The grid is uniform, hence it is stored as image data described by the
+ * origin, spacing, and extent instead of coordinates of nodes.
+ * In binary mode, arrays are stored as raw appended data, each preceded by
+ * its byte count, and data array headers record their offsets into the
+ * appended section.
+ */
 static void WriteStructuredData(const Space *space, const Model *model, PvSet *pvSet)
 {
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
-    FILE *fp = Fopen(pvSet->fname, "w");
-    PvReal data = 0.0; /* paraview scalar data */
-    PvReal Vec[3] = {0.0}; /* paraview vector data */
+    FILE *fp = Fopen(pvSet->fname, "wb");
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
-    const Real *restrict U = NULL;
-    int idx = 0; /* linear array index math variable */
     IntVec ne = {0}; /* i, j, k node number in each part */
     ne[X] = part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN] - 1;
     ne[Y] = part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN] - 1;
     ne[Z] = part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN] - 1;
+    RealVec O = {0.0}; /* origin */
+    for (int s = 0; s < DIMS; ++s) {
+        O[s] = MapPoint(part->ns[PIO][s][MIN], part->domain[s][MIN], part->d[s], part->ng[s]);
+    }
+    const size_t nodeN = (size_t)(ne[X] + 1) * (ne[Y] + 1) * (ne[Z] + 1);
+    size_t offset = 0; /* offset of a data array in appended data */
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
-    fprintf(fp, "<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
-    fprintf(fp, "  <StructuredGrid WholeExtent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
+    if (PVBINARY == pvSet->encoding) {
+        const PvUInt one = 1; /* raw data are in native byte order */
+        if (1 != *(const unsigned char *)&one) {
+            strncpy(pvSet->byteOrder, "BigEndian", sizeof(PvStr));
+        }
+        fprintf(fp, "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\">\n",
+                pvSet->byteOrder);
+    } else {
+        fprintf(fp, "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
+    }
+    fprintf(fp, "  <ImageData WholeExtent=\"%d %d %d %d %d %d\" Origin=\"%.9g %.9g %.9g\" Spacing=\"%.9g %.9g %.9g\">\n",
+            0, ne[X], 0, ne[Y], 0, ne[Z], O[X], O[Y], O[Z], part->d[X], part->d[Y], part->d[Z]);
     fprintf(fp, "    <Piece Extent=\"%d %d %d %d %d %d\">\n", 0, ne[X], 0, ne[Y], 0, ne[Z]);
     fprintf(fp, "      <PointData>\n");
     for (int s = 0; s < pvSet->scaN; ++s) {
-        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" format=\"ascii\">\n", pvSet->floatType, pvSet->sca[s]);
-        fprintf(fp, "          ");
-        for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
-            for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
-                for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
-                    switch (s) {
-                        case 0: /* rho */
-                            data = U[0];
-                            break;
-                        case 1: /* u */
-                            data = U[1] / U[0];
-                            break;
-                        case 2: /* v */
-                            data = U[2] / U[0];
-                            break;
-                        case 3: /* w */
-                            data = U[3] / U[0];
-                            break;
-                        case 4: /* p */
-                            data = ComputePressure(model->gamma, U);
-                            break;
-                        case 5: /* T */
-                            data = ComputeTemperature(model->cv, U);
-                            break;
-                        case 6: /* node flag */
-                            data = node[idx].did;
-                            break;
-                        case 7: /* face flag */
-                            data = node[idx].fid;
-                            break;
-                        case 8: /* layer flag */
-                            data = node[idx].lid;
-                            break;
-                        case 9: /* ghost flag */
-                            data = node[idx].gst;
-                            break;
-                        default:
-                            break;
-                    }
-                    fprintf(fp, "%.6g ", data);
-                }
-            }
-        }
-        fprintf(fp, "\n        </DataArray>\n");
+        WriteDataArray(fp, s, pvSet->sca[s], 1, nodeN, &offset, space, model, pvSet);
     }
     for (int s = 0; s < pvSet->vecN; ++s) {
-        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType, pvSet->vec[s]);
-        fprintf(fp, "          ");
+        WriteDataArray(fp, PVDATAVEL + s, pvSet->vec[s], 3, nodeN, &offset, space, model, pvSet);
+    }
+    fprintf(fp, "      </PointData>\n");
+    fprintf(fp, "      <CellData>\n");
+    fprintf(fp, "      </CellData>\n");
+    fprintf(fp, "    </Piece>\n");
+    fprintf(fp, "  </ImageData>\n");
+    if (PVBINARY == pvSet->encoding) {
+        float *data = AssignStorage(3 * nodeN * sizeof(*data));
+        fprintf(fp, "  <AppendedData encoding=\"raw\">\n");
+        fprintf(fp, "   _");
+        for (int s = 0; s < pvSet->scaN; ++s) {
+            WriteAppendedData(fp, s, space, model, data);
+        }
+        for (int s = 0; s < pvSet->vecN; ++s) {
+            WriteAppendedData(fp, PVDATAVEL + s, space, model, data);
+        }
+        fprintf(fp, "\n  </AppendedData>\n");
+        RetrieveStorage(data);
+    }
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
+    return;
+}
+static void WriteDataArray(FILE *fp, const int s, const char *name, const int comp, const size_t nodeN,
+        size_t *offset, const Space *space, const Model *model, const PvSet *pvSet)
+{
+    PvStr fmt = {'\0'}; /* data array format */
+    PvStr ncomp = {'\0'}; /* number of components */
+    if (1 < comp) {
+        snprintf(ncomp, sizeof(PvStr), " NumberOfComponents=\"%d\"", comp);
+    }
+    if (PVBINARY == pvSet->encoding) {
+        snprintf(fmt, sizeof(PvStr), "format=\"appended\" offset=\"%zu\"", *offset);
+        *offset = *offset + sizeof(PvUInt) + comp * nodeN * sizeof(float);
+        fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\"%s %s/>\n", pvSet->floatType, name, ncomp, fmt);
+        return;
+    }
+    fprintf(fp, "        <DataArray type=\"%s\" Name=\"%s\"%s format=\"ascii\">\n", pvSet->floatType, name, ncomp);
+    fprintf(fp, "          ");
+    WriteNodeData(fp, s, space, model);
+    fprintf(fp, "\n        </DataArray>\n");
+    return;
+}
+static void WriteAppendedData(FILE *fp, const int s, const Space *space, const Model *model, float *data)
+{
+    const PvUInt size = PackNodeData(s, space, model, data) * sizeof(*data);
+    fwrite(&size, sizeof(size), 1, fp);
+    fwrite(data, sizeof(char), size, fp);
+    return;
+}
+/*
+ * Node data are formatted line by line into text buffers by threads, and
+ * the buffers are written to file in line order. Hence the file is the
+ * same for any number of threads.
+ */
+static void WriteNodeData(FILE *fp, const int s, const Space *space, const Model *model)
+{
+    const Partition *const part = &(space->part);
+    const size_t size = (part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN]) * PVNODESTR + 1;
+#pragma omp parallel
+    {
+        char *str = AssignStorage(size);
+        size_t len = 0;
+#pragma omp for collapse(2) ordered schedule(static, 1)
         for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
             for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
+                len = 0;
                 for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    U = node[idx].U[TO];
-                    Vec[X] = U[1] / U[0];
-                    Vec[Y] = U[2] / U[0];
-                    Vec[Z] = U[3] / U[0];
-                    fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+                    len = len + FormatNodeData(s, k, j, i, space, model, str + len);
+                }
+#pragma omp ordered
+                {
+                    fwrite(str, sizeof(char), len, fp);
                 }
             }
         }
-        fprintf(fp, "\n        </DataArray>\n");
+        RetrieveStorage(str);
     }
-    fprintf(fp, "      </PointData>\n");
-    fprintf(fp, "      <CellData>\n");
-    fprintf(fp, "      </CellData>\n");
-    fprintf(fp, "      <Points>\n");
-    fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
-    fprintf(fp, "          ");
+    return;
+}
+static int FormatNodeData(const int s, const int k, const int j, const int i,
+        const Space *space, const Model *model, char *str)
+{
+    PvReal Vec[3] = {0.0}; /* paraview vector data */
+    if (1 == ComputeNodeData(s, k, j, i, space, model, Vec)) {
+        return snprintf(str, PVNODESTR, "%.6g ", Vec[X]);
+    }
+    return snprintf(str, PVNODESTR, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+}
+/*
+ * Node data are packed in single precision by threads, and return the
+ * number of packed values.
+ */
+static size_t PackNodeData(const int s, const Space *space, const Model *model, float *data)
+{
+    const Partition *const part = &(space->part);
+    const int comp = (PVDATAVEL <= s) ? 3 : 1;
+    const size_t nx = part->ns[PIO][X][MAX] - part->ns[PIO][X][MIN];
+    const size_t ny = part->ns[PIO][Y][MAX] - part->ns[PIO][Y][MIN];
+    const size_t nz = part->ns[PIO][Z][MAX] - part->ns[PIO][Z][MIN];
+#pragma omp parallel for collapse(2) schedule(static)
     for (int k = part->ns[PIO][Z][MIN]; k < part->ns[PIO][Z][MAX]; ++k) {
         for (int j = part->ns[PIO][Y][MIN]; j < part->ns[PIO][Y][MAX]; ++j) {
+            PvReal Vec[3] = {0.0}; /* paraview vector data */
+            size_t m = (((k - part->ns[PIO][Z][MIN]) * ny) + (j - part->ns[PIO][Y][MIN])) * nx * comp;
             for (int i = part->ns[PIO][X][MIN]; i < part->ns[PIO][X][MAX]; ++i) {
-                Vec[X] = MapPoint(i, part->domain[X][MIN], part->d[X], part->ng[X]);
-                Vec[Y] = MapPoint(j, part->domain[Y][MIN], part->d[Y], part->ng[Y]);
-                Vec[Z] = MapPoint(k, part->domain[Z][MIN], part->d[Z], part->ng[Z]);
-                fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
+                ComputeNodeData(s, k, j, i, space, model, Vec);
+                for (int c = 0; c < comp; ++c) {
+                    data[m] = Vec[c];
+                    ++m;
+                }
             }
         }
     }
-    fprintf(fp, "\n        </DataArray>\n");
-    fprintf(fp, "      </Points>\n");
-    fprintf(fp, "    </Piece>\n");
-    fprintf(fp, "  </StructuredGrid>\n");
-    fprintf(fp, "</VTKFile>\n");
-    fclose(fp);
-    return;
+    return nx * ny * nz * comp;
+}
+/*
+ * Compute the data of a node and return the number of components.
+ */
+static int ComputeNodeData(const int s, const int k, const int j, const int i,
+        const Space *space, const Model *model, PvReal Vec[restrict])
+{
+    const Partition *const part = &(space->part);
+    const Field *const field = &(space->field);
+    const int idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+    Real U[DIMU] = {0.0};
+    switch (s) {
+        case PVDATAVEL: /* velocity */
+            if (TO == field->tc) {
+                Vec[X] = field->Uc[1][idx];
+                Vec[Y] = field->Uc[2][idx];
+                Vec[Z] = field->Uc[3][idx];
+                return 3;
+            }
+            LoadU(idx, field->U[TO], U);
+            Vec[X] = U[1] / U[0];
+            Vec[Y] = U[2] / U[0];
+            Vec[Z] = U[3] / U[0];
+            return 3;
+        default:
+            break;
+    }
+    if ((TO == field->tc) && (DIMUc > s)) { /* primitive variables from cache */
+        Vec[X] = field->Uc[s][idx];
+        return 1;
+    }
+    LoadU(idx, field->U[TO], U);
+    switch (s) {
+        case 0: /* rho */
+            Vec[X] = U[0];
+            break;
+        case 1: /* u */
+            Vec[X] = U[1] / U[0];
+            break;
+        case 2: /* v */
+            Vec[X] = U[2] / U[0];
+            break;
+        case 3: /* w */
+            Vec[X] = U[3] / U[0];
+            break;
+        case 4: /* p */
+            Vec[X] = ComputePressure(model->gamma, U);
+            break;
+        case 5: /* T */
+            Vec[X] = ComputeTemperature(model->cv, U);
+            break;
+        case 6: /* node flag */
+            Vec[X] = field->did[idx];
+            break;
+        case 7: /* face flag */
+            Vec[X] = field->fid[idx];
+            break;
+        case 8: /* layer flag */
+            Vec[X] = field->lid[idx];
+            break;
+        case 9: /* ghost flag */
+            Vec[X] = field->gst[idx];
+            break;
+        default:
+            break;
+    }
+    return 1;
 }
 void WritePolyDataParaview(const Time *time, const Geometry *const geo)
 {
@@ -343,6 +478,7 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
     snprintf(pvSet->fname, sizeof(PvStr), "%s%s", pvSet->bname, pvSet->fext);
     FILE *fp = Fopen(pvSet->fname, "w");
     PvReal Vec[3] = {0.0}; /* paraview vector data */
+    RealVec v = {0.0}; /* vertex in current frame */
     const Polyhedron *poly = NULL;
     fprintf(fp, "<?xml version=\"1.0\"?>\n");
     fprintf(fp, "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"%s\">\n", pvSet->byteOrder);
@@ -363,9 +499,10 @@ static void WritePolygonPolyData(const int pm, const int pn, const Geometry *con
         fprintf(fp, "        <DataArray type=\"%s\" Name=\"points\" NumberOfComponents=\"3\" format=\"ascii\">\n", pvSet->floatType);
         fprintf(fp, "          ");
         for (int n = 0; n < poly->vertN; ++n) {
-            Vec[X] = poly->v[n][X];
-            Vec[Y] = poly->v[n][Y];
-            Vec[Z] = poly->v[n][Z];
+            MapVertex(n, poly, v);
+            Vec[X] = v[X];
+            Vec[Y] = v[Y];
+            Vec[Z] = v[Z];
             fprintf(fp, "%.6g %.6g %.6g ", Vec[X], Vec[Y], Vec[Z]);
         }
         fprintf(fp, "\n        </DataArray>\n");
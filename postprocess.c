@@ -38,15 +38,32 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     Polyhedron *poly = NULL;
     for (int n = geo->sphN; n < geo->totN; ++n) {
         poly = geo->poly + n;
+        if (0 != poly->ref) { /* shared mesh is released by its owner */
+            continue;
+        }
         RetrieveStorage(poly->f);
         RetrieveStorage(poly->Nf);
         RetrieveStorage(poly->e);
         RetrieveStorage(poly->Ne);
         RetrieveStorage(poly->v);
         RetrieveStorage(poly->Nv);
+        RetrieveStorage(poly->bvh);
+        RetrieveStorage(poly->fo);
+        RetrieveStorage(poly->df.d);
+        RetrieveStorage(poly->df.fid);
+    }
+    for (int n = 0; n < geo->totN; ++n) {
+        RetrieveStorage(geo->poly[n].ghost);
+        RetrieveStorage(geo->poly[n].sten.idx);
+        RetrieveStorage(geo->poly[n].sten.w);
     }
     RetrieveStorage(geo->poly);
     RetrieveStorage(geo->col);
+    RetrieveStorage(geo->slot);
+    RetrieveStorage(geo->cl.head);
+    RetrieveStorage(geo->cl.item);
+    RetrieveStorage(geo->cl.active);
+    RetrieveStorage(geo->cl.mark);
     /* space related */
     Partition *const part = &(space->part);
     RetrieveStorage(part->typeBC);
@@ -55,7 +72,7 @@ static void ReleaseProgramMemory(Time *time, Space *space, Model *model)
     RetrieveStorage(part->typeIC);
     RetrieveStorage(part->posIC);
     RetrieveStorage(part->varIC);
-    RetrieveStorage(space->node);
+    RetrieveStorage(space->field.store);
     /* time related */
     RetrieveStorage(time->lp);
     RetrieveStorage(time->pp);
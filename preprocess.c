@@ -14,6 +14,7 @@
 #include "preprocess.h"
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
+#include <stdint.h> /* fixed width integer types */
 #include "case_loader.h"
 #include "cfd_parameters.h"
 #include "domain_partition.h"
@@ -22,6 +23,7 @@
  * Static Function Declarations
  ****************************************************************************/
 static void AllocateProgramMemory(Space *, Model *);
+static void AllocateFieldMemory(const int, const int, Field *const);
 /****************************************************************************
  * Function Definitions
  ****************************************************************************/
@@ -49,13 +51,53 @@ static void AllocateProgramMemory(Space *space, Model *model)
     Partition *const part = &(space->part);
     Geometry *const geo = &(space->geo);
     const int totN = part->n[X] * part->n[Y] * part->n[Z];
-    space->node = AssignStorage(totN * sizeof(*space->node));
+    AllocateFieldMemory(totN, model->pCache, &(space->field));
     if (0 != geo->totN) {
         geo->col = AssignStorage(geo->totN * sizeof(*geo->col));
+        geo->slot = AssignStorage((geo->totN + 1) * sizeof(*geo->slot));
         geo->poly = AssignStorage(geo->totN * sizeof(*geo->poly));
     }
     model->mat = AssignStorage(sizeof(*model->mat));
     return;
 }
+/*
+ * Field data are stored as structure of arrays: each flag and each
+ * conservative variable of each time level owns a contiguous array, so that
+ * a sweep only streams the quantities it actually uses. All arrays are
+ * carved from a single storage block, and each array starts on a cache line
+ * boundary to keep vector loads aligned. Only the time levels used by the
+ * temporal scheme are stored, and the primitive cache only takes storage
+ * when it is enabled.
+ */
+static void AllocateFieldMemory(const int totN, const int pCache, Field *const field)
+{
+    const size_t align = 64; /* byte alignment of each field array */
+    const size_t sizeI = (totN * sizeof(int) + align - 1) / align * align;
+    const size_t sizeR = (totN * sizeof(Real) + align - 1) / align * align;
+    const int cacheN = (0 != pCache) ? DIMUc : 0; /* number of cache arrays */
+    field->store = AssignStorage(4 * sizeI + (field->tl * DIMU + cacheN) * sizeR + align);
+    uintptr_t addr = ((uintptr_t)field->store + align - 1) / align * align;
+    field->did = (int *)addr;
+    addr = addr + sizeI;
+    field->fid = (int *)addr;
+    addr = addr + sizeI;
+    field->lid = (int *)addr;
+    addr = addr + sizeI;
+    field->gst = (int *)addr;
+    addr = addr + sizeI;
+    for (int tn = 0; tn < field->tl; ++tn) {
+        for (int n = 0; n < DIMU; ++n) {
+            field->U[tn][n] = (Real *)addr;
+            addr = addr + sizeR;
+        }
+    }
+    for (int n = 0; n < cacheN; ++n) {
+        field->Uc[n] = (Real *)addr;
+        addr = addr + sizeR;
+    }
+    field->tc = NONE;
+    field->tv = NONE;
+    return;
+}
 /* a good practice: end file with a newline */
 
@@ -15,6 +15,9 @@
 #include <stdio.h> /* standard library for input and output */
 #include <stdlib.h> /* dynamic memory allocation and exit */
 #include <string.h> /* manipulating strings */
+#ifdef _OPENMP
+#include <omp.h> /* shared memory parallelization */
+#endif
 #include "calculator.h"
 #include "case_generator.h"
 #include "commons.h"
@@ -112,9 +115,24 @@ static void ConfigureProgram(Control *control, Space *space)
             part->proc[Y] = 1;
             part->proc[Z] = 1;
             part->procN = 1;
+#ifdef _OPENMP
+            omp_set_num_threads(1);
+#endif
+            break;
+        case 'o': /* omp mode, the number of threads is nx*ny*nz */
+            part->proc[X] = control->proc[X];
+            part->proc[Y] = control->proc[Y];
+            part->proc[Z] = control->proc[Z];
+            part->procN = control->proc[X] *
+                control->proc[Y] * control->proc[Z];
+#ifdef _OPENMP
+            if (0 < part->procN) {
+                omp_set_num_threads(part->procN);
+            }
+#else
+            ShowWarning("omp mode requires compiling with openmp enabled\n");
+#endif
             break;
-        case 'o': /* omp mode */
-            /* fall through */
         case 'm': /* mpi mode */
             part->proc[X] = control->proc[X];
             part->proc[Y] = control->proc[Y];
@@ -192,6 +210,8 @@ static void ShowManual(void)
     ShowInfo("        -n nprocessors    processors per dimension: nx*ny*nz\n");
     ShowInfo("NOTES:\n");
     ShowInfo("        default run mode is gui\n");
+    ShowInfo("        omp mode runs nx*ny*nz threads, results do not\n");
+    ShowInfo("        depend on the number of threads\n");
     return;
 }
 /* a good practice: end file with a newline */
@@ -18,17 +18,29 @@
 #include <float.h> /* size of floating point values */
 #include <string.h> /* manipulating strings */
 #include "immersed_boundary.h"
+#include "boundary_treatment.h"
 #include "computational_geometry.h"
 #include "linear_system.h"
 #include "cfd_commons.h"
 #include "commons.h"
+/****************************************************************************
+ * Data Structure Declarations
+ ****************************************************************************/
+typedef struct {
+    RealVec Fp; /* pressure force */
+    RealVec Fv; /* viscous force */
+    RealVec Tt; /* torque */
+    Real fvar[2]; /* force offset and its square */
+} ForceSum; /* surface force contribution of a ghost node */
 /****************************************************************************
  * Static Function Declarations
  ****************************************************************************/
 static void ApplyKinematics(const Real, const Real, Space *);
 static void ApplyCollision(Space *);
+static int ComputeContact(const Real, const int [restrict], const Polyhedron *,
+        const Polyhedron *, Real [restrict]);
 static void DetectColState(const int, const int, const int, const int, const int,
-        const int [restrict][DIMS], const Node *const, const Partition *const,
+        const int [restrict][DIMS], const Field *const, const Partition *const,
         Geometry *const);
 static void AddColObject(const int [restrict], const int, Geometry *const);
 static void ApplyMotion(const Real, Space *);
@@ -45,114 +57,132 @@ void EvolveSolidDynamics(const Real now, const Real dt, Space *space, const Mode
     ApplyMotion(dt, space);
     ComputeGeometricField(space, model);
     TreatImmersedBoundary(TO, space, model);
+    RefreshPrimitiveCache(TO, space, model);
     return;
 }
+/*
+ * Contributions of ghost nodes of all indexed polyhedrons are computed by
+ * threads as one work list, then summed into partial sums of each grid line
+ * in node order, which are added up in line order for each polyhedron.
+ * Therefore, the result does not depend on the number of threads.
+ */
 void IntegrateSurfaceForce(Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     Geometry *const geo = &(space->geo);
-    const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
-    const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
-    const RealVec sMin = {part->domain[X][MIN], part->domain[Y][MIN], part->domain[Z][MIN]};
-    const RealVec d = {part->d[X], part->d[Y], part->d[Z]};
-    const RealVec dd = {part->dd[X], part->dd[Y], part->dd[Z]};
-    const IntVec ng = {part->ng[X], part->ng[Y], part->ng[Z]};
+    const CellList *const cl = &(geo->cl);
     const Real zero = 0.0;
     const Real percent = FLT_EPSILON * FLT_EPSILON;
     Polyhedron *poly = NULL;
-    int idx = 0; /* linear array index math variable */
-    int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
     int lidN = 0; /* count total number of interfacial nodes */
     int gstN = 0; /* count total number of ghost nodes */
-    RealVec pG = {zero}; /* ghost point */
-    RealVec pO = {zero}; /* boundary point */
-    RealVec pI = {zero}; /* image point */
-    RealVec N = {zero}; /* normal */
-    Real Uo[DIMUo] = {zero};
-    RealVec V = {zero}; /* velocity vector */
-    RealVec r = {zero}; /* position vector */
-    RealVec Fp = {zero}; /* pressure force */
-    RealVec Fv = {zero}; /* viscous force */
-    RealVec Fs = {zero}; /* surface force */
-    RealVec Tt = {zero}; /* torque */
     RealVec fvar = {zero}; /* force offset, mean, variance */
-    Real Vn = zero; /* velocity projection */
-    Real mu = zero; /* viscosity */
     Real ds = zero; /* infinitesimal area for integration */
+    Real UoF[DIMUo] = {zero}; /* primitive values of the first ghost node */
+    ForceSum line = {{zero}, {zero}, {zero}, {zero}}; /* partial sums of a grid line */
+    /* reset some non accumulative information to zero */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
         if (0 < poly->state) { /* surface force negligible */
             continue;
         }
-        /* reset some non accumulative information to zero */
         memset(poly->Fp, 0, DIMS * sizeof(*poly->Fp));
         memset(poly->Fv, 0, DIMS * sizeof(*poly->Fv));
         memset(poly->Tt, 0, DIMS * sizeof(*poly->Tt));
-        memset(fvar, 0, DIMS * sizeof(*fvar));
-        lidN = 0;
-        gstN = 0;
-        /* determine search range according to bounding box of polyhedron and valid node space */
-        for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(poly->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(poly->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((2 == node[idx].lid) && (n + 1 == node[idx].did)) {
-                        ++lidN; /* an interfacial node of current geometry */
-                    }
-                    if ((2 != node[idx].gst) || (n + 1 != node[idx].did)) {
-                        continue;
-                    }
-                    ++gstN; /* a ghost node of current geometry */
-                    /* surface force exerted by fluid (pressure + shear force) */
-                    pG[X] = MapPoint(i, sMin[X], d[X], ng[X]);
-                    pG[Y] = MapPoint(j, sMin[Y], d[Y], ng[Y]);
-                    pG[Z] = MapPoint(k, sMin[Z], d[Z], ng[Z]);
-                    ComputeGeometricData(pG, node[idx].fid, poly, pO, pI, N);
-                    r[X] = pO[X] - poly->O[X];
-                    r[Y] = pO[Y] - poly->O[Y];
-                    r[Z] = pO[Z] - poly->O[Z];
-                    MapPrimitive(model->gamma, model->gasR, node[idx].U[TO], Uo);
-                    Fp[X] = Uo[4] * N[X];
-                    Fp[Y] = Uo[4] * N[Y];
-                    Fp[Z] = Uo[4] * N[Z];
-                    if (1 == gstN) {
-                        fvar[0] = Uo[4];
-                    }
-                    fvar[1] = fvar[1] + Uo[4] - fvar[0];
-                    fvar[2] = fvar[2] + (Uo[4] - fvar[0]) * (Uo[4] - fvar[0]);
-                    if ((zero < model->refMu) && (zero < poly->cf)) {
-                        mu = model->refMu * Viscosity(Uo[5] * model->refT);
-                        Cross(poly->W[TO], r, V);
-                        V[X] = Uo[1] - (poly->V[TO][X] + V[X]);
-                        V[Y] = Uo[2] - (poly->V[TO][Y] + V[Y]);
-                        V[Z] = Uo[3] - (poly->V[TO][Z] + V[Z]);
-                        Vn = Dot(V, N);
-                        Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
-                        Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
-                        Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
-                    } else {
-                        memset(Fv, 0, DIMS * sizeof(*Fv));
-                    }
-                    Fs[X] = Fp[X] + Fv[X];
-                    Fs[Y] = Fp[Y] + Fv[Y];
-                    Fs[Z] = Fp[Z] + Fv[Z];
-                    Cross(r, Fs, Tt);
-                    /* integration sum */
-                    for (int s = 0; s < DIMS; ++s) {
-                        poly->Fp[s] = poly->Fp[s] + Fp[s];
-                        poly->Fv[s] = poly->Fv[s] + Fv[s];
-                        poly->Tt[s] = poly->Tt[s] + Tt[s];
-                    }
-                }
+    }
+    /* ghost nodes of the second layer, polyhedrons out of the indexed region have none */
+    int *gsum = AssignStorage((cl->activeN + 1) * sizeof(*gsum));
+    Real *pref = AssignStorage((cl->activeN + 1) * sizeof(*pref)); /* offset of force variance */
+    for (int m = 0; m < cl->activeN; ++m) {
+        poly = geo->poly + cl->active[m];
+        gstN = (0 < poly->state) ? 0 : poly->gs[2] - poly->gs[1];
+        gsum[m + 1] = gsum[m] + gstN;
+        if (0 == gstN) {
+            continue;
+        }
+        /* pressure of the first ghost node as the offset of force variance to avoid catastrophic cancellation */
+        LoadPrimitive(TO, poly->ghost[poly->gs[1]].idx, field, model, UoF);
+        pref[m] = UoF[4];
+    }
+    ForceSum *sum = AssignStorage((gsum[cl->activeN] + 1) * sizeof(*sum));
+#pragma omp parallel for schedule(static)
+    for (int g = 0; g < gsum[cl->activeN]; ++g) {
+        const int m = LocateGhost(g, cl->activeN, gsum);
+        const Polyhedron *const polg = geo->poly + cl->active[m];
+        const Ghost *const ghost = polg->ghost + polg->gs[1] + g - gsum[m];
+        const Real *const pG = ghost->pG; /* ghost point */
+        const Real *const pO = ghost->pO; /* boundary point */
+        const Real *const N = ghost->N; /* normal */
+        Real Uo[DIMUo] = {zero};
+        RealVec V = {zero}; /* velocity vector */
+        RealVec r = {zero}; /* position vector */
+        RealVec Fs = {zero}; /* surface force */
+        Real Vn = zero; /* velocity projection */
+        Real mu = zero; /* viscosity */
+        Real *const Fp = sum[g].Fp; /* pressure force */
+        Real *const Fv = sum[g].Fv; /* viscous force */
+        /* surface force exerted by fluid (pressure + shear force) */
+        r[X] = pO[X] - polg->O[X];
+        r[Y] = pO[Y] - polg->O[Y];
+        r[Z] = pO[Z] - polg->O[Z];
+        LoadPrimitive(TO, ghost->idx, field, model, Uo);
+        Fp[X] = Uo[4] * N[X];
+        Fp[Y] = Uo[4] * N[Y];
+        Fp[Z] = Uo[4] * N[Z];
+        sum[g].fvar[0] = Uo[4] - pref[m];
+        sum[g].fvar[1] = (Uo[4] - pref[m]) * (Uo[4] - pref[m]);
+        if ((zero < model->refMu) && (zero < polg->cf)) {
+            mu = model->refMu * Viscosity(Uo[5] * model->refT);
+            Cross(polg->W[TO], r, V);
+            V[X] = Uo[1] - (polg->V[TO][X] + V[X]);
+            V[Y] = Uo[2] - (polg->V[TO][Y] + V[Y]);
+            V[Z] = Uo[3] - (polg->V[TO][Z] + V[Z]);
+            Vn = Dot(V, N);
+            Fv[X] = mu * (V[X] - Vn * N[X]) / Dist(pG, pO);
+            Fv[Y] = mu * (V[Y] - Vn * N[Y]) / Dist(pG, pO);
+            Fv[Z] = mu * (V[Z] - Vn * N[Z]) / Dist(pG, pO);
+        }
+        Fs[X] = Fp[X] + Fv[X];
+        Fs[Y] = Fp[Y] + Fv[Y];
+        Fs[Z] = Fp[Z] + Fv[Z];
+        Cross(r, Fs, sum[g].Tt);
+    }
+    for (int m = 0; m < cl->activeN; ++m) {
+        poly = geo->poly + cl->active[m];
+        gstN = gsum[m + 1] - gsum[m];
+        if (0 == gstN) { /* no surface force exerted */
+            continue;
+        }
+        const Ghost *const ghost = poly->ghost + poly->gs[1];
+        const ForceSum *const sumP = sum + gsum[m];
+        lidN = poly->lidN[2];
+        fvar[0] = pref[m];
+        fvar[1] = zero;
+        fvar[2] = zero;
+        /* add up contributions into line sums in node order, then line sums in line order */
+        for (int n = 0; n < gstN; ++n) {
+            for (int s = 0; s < DIMS; ++s) {
+                line.Fp[s] = line.Fp[s] + sumP[n].Fp[s];
+                line.Fv[s] = line.Fv[s] + sumP[n].Fv[s];
+                line.Tt[s] = line.Tt[s] + sumP[n].Tt[s];
+            }
+            line.fvar[0] = line.fvar[0] + sumP[n].fvar[0];
+            line.fvar[1] = line.fvar[1] + sumP[n].fvar[1];
+            if ((gstN - 1 > n) && (ghost[n].idx / part->n[X] == ghost[n + 1].idx / part->n[X])) {
+                continue; /* the grid line continues */
+            }
+            for (int s = 0; s < DIMS; ++s) {
+                poly->Fp[s] = poly->Fp[s] + line.Fp[s];
+                poly->Fv[s] = poly->Fv[s] + line.Fv[s];
+                poly->Tt[s] = poly->Tt[s] + line.Tt[s];
             }
+            fvar[1] = fvar[1] + line.fvar[0];
+            fvar[2] = fvar[2] + line.fvar[1];
+            memset(&line, 0, sizeof(line));
         }
         /* calibrate the sum of discrete forces into integration */
-        if ((0 == lidN) || (0 == gstN)) { /* no surface force exerted */
+        if (0 == lidN) { /* no surface force exerted */
             continue;
         }
         ds = poly->area / lidN;
@@ -167,6 +197,9 @@ void IntegrateSurfaceForce(Space *space, const Model *model)
             poly->Tt[s] = -poly->Tt[s] * ds;
         }
     }
+    RetrieveStorage(sum);
+    RetrieveStorage(pref);
+    RetrieveStorage(gsum);
     return;
 }
 static void ApplyKinematics(const Real now, const Real dt, Space *space)
@@ -210,10 +243,20 @@ static void ApplyKinematics(const Real now, const Real dt, Space *space)
     }
     return;
 }
+/*
+ * Candidate pairs are found by querying the cell list with the bounding box
+ * of a polyhedron extended by the contact distance, which is one node
+ * spacing as in the node based detection. Pairs with an analytical sphere
+ * are resolved analytically: the line of impact is the line of centers of
+ * two spheres, and the surface normal at the point of a triangulated
+ * polyhedron closest to the sphere center otherwise. Only pairs of
+ * triangulated polyhedrons search heterogeneous neighbours of interfacial
+ * nodes, hence the cost scales with contacts rather than volumes of boxes.
+ */
 static void ApplyCollision(Space *space)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     Geometry *const geo = &(space->geo);
     const IntVec nMin = {part->ns[PIN][X][MIN], part->ns[PIN][Y][MIN], part->ns[PIN][Z][MIN]};
     const IntVec nMax = {part->ns[PIN][X][MAX], part->ns[PIN][Y][MAX], part->ns[PIN][Z][MAX]};
@@ -229,6 +272,7 @@ static void ApplyCollision(Space *space)
     Collision *col = NULL;
     int idx = 0; /* linear array index math variable */
     int box[DIMS][LIMIT] = {{0}}; /* bounding box in node space */
+    Real cbox[DIMS][LIMIT] = {{zero}}; /* bounding box extended by contact distance */
     RealVec Vo = {zero}; /* original translational velocity */
     RealVec Wo = {zero}; /* original rotational velocity */
     RealVec V = {zero}; /* relative translational velocity */
@@ -240,25 +284,63 @@ static void ApplyCollision(Space *space)
     Real mp = zero; /* mass */
     Real mn = zero; /* mass */
     Real meff = zero; /* effective mass */
-    for (int p = 0; p < geo->totN; ++p) {
+    Real h = zero; /* contact distance */
+    IntVec nd = {0}; /* dimensions with neighbouring nodes, collapsed dimensions excluded */
+    for (int s = 0; s < DIMS; ++s) {
+        nd[s] = (1 < nMax[s] - nMin[s]);
+        if (nd[s]) {
+            h = MaxReal(h, part->d[s]);
+        }
+    }
+    int *list = AssignStorage(geo->totN * sizeof(*list)); /* candidate list */
+    /* polyhedrons out of the indexed region have no interfacial nodes */
+    for (int m = 0; m < geo->cl.activeN; ++m) {
+        const int p = geo->cl.active[m];
         polp = geo->poly + p;
         if (1 == polp->state) { /* stationary object */
             continue;
         }
         geo->colN = 0; /* reset */
-        /* determine search range according to bounding box of polyhedron and valid node space */
+        /* broad phase */
         for (int s = 0; s < DIMS; ++s) {
-            box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
-            box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
-        }
-        for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
-            for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
-                for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
-                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                    if ((1 != node[idx].lid) || (p + 1 != node[idx].did)) {
-                        continue;
+            cbox[s][MIN] = polp->box[s][MIN] - h;
+            cbox[s][MAX] = polp->box[s][MAX] + h;
+        }
+        const int listN = QueryCellList(cbox, geo, list);
+        int stlN = 0; /* candidates of node based detection */
+        for (int l = 0; l < listN; ++l) {
+            if (p == list[l]) {
+                continue;
+            }
+            poln = geo->poly + list[l];
+            if ((0 < polp->faceN) && (0 < poln->faceN)) {
+                ++stlN;
+                continue;
+            }
+            if (!ComputeContact(h, nd, polp, poln, N)) {
+                continue;
+            }
+            col = geo->col + geo->colN;
+            col->gid = list[l] + 1;
+            memcpy(col->N, N, DIMS * sizeof(*N));
+            geo->slot[col->gid] = geo->colN;
+            ++(geo->colN);
+        }
+        if (0 < stlN) {
+            /* determine search range according to bounding box of polyhedron and valid node space */
+            for (int s = 0; s < DIMS; ++s) {
+                box[s][MIN] = ConfineSpace(MapNode(polp->box[s][MIN], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]);
+                box[s][MAX] = ConfineSpace(MapNode(polp->box[s][MAX], sMin[s], dd[s], ng[s]), nMin[s], nMax[s]) + 1;
+            }
+            for (int k = box[Z][MIN]; k < box[Z][MAX]; ++k) {
+                for (int j = box[Y][MIN]; j < box[Y][MAX]; ++j) {
+                    for (int i = box[X][MIN]; i < box[X][MAX]; ++i) {
+                        idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                        if ((1 != field->lid[idx]) || (p + 1 != field->did[idx])) {
+                            continue;
+                        }
+                        DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, field, part, geo);
                     }
-                    DetectColState(k, j, i, p + 1, part->pathSep[1], part->path, node, part, geo);
                 }
             }
         }
@@ -277,7 +359,7 @@ static void ApplyCollision(Space *space)
         for (int n = 0; n < geo->colN; ++n) {
             col = geo->col + n;
             /* line of impact */
-            if (0 == abs(col->N[X]) + abs(col->N[Y]) + abs(col->N[Z])) {
+            if (zero == Norm(col->N)) {
                 if ((geo->colN - 1 == n) && (coltag > polp->state)) {
                     /* recover contacting but none colliding polyhedron */
                     memcpy(polp->V[TO], Vo, DIMS * sizeof(*polp->V[TO]));
@@ -285,9 +367,7 @@ static void ApplyCollision(Space *space)
                 }
                 continue;
             }
-            N[X] = col->N[X];
-            N[Y] = col->N[Y];
-            N[Z] = col->N[Z];
+            memcpy(N, col->N, DIMS * sizeof(*N));
             Normalize(DIMS, Norm(N), N);
             poln = geo->poly + col->gid - 1;
             /* relative speed */
@@ -329,10 +409,48 @@ static void ApplyCollision(Space *space)
         memcpy(polp->V[TN], polp->V[TO], DIMS * sizeof(*polp->V[TO]));
         memcpy(polp->W[TN], polp->W[TO], DIMS * sizeof(*polp->W[TO]));
     }
+    RetrieveStorage(list);
     return;
 }
+/*
+ * The line of impact points from the first polyhedron to the second one
+ * and has no component on collapsed dimensions. Returns 1 if the gap
+ * between surfaces is within the contact distance.
+ */
+static int ComputeContact(const Real h, const int nd[restrict], const Polyhedron *polp,
+        const Polyhedron *poln, Real N[restrict])
+{
+    const Real zero = 0.0;
+    RealVec pi = {zero}; /* closest point on triangulated surface */
+    Real gap = zero; /* distance between surfaces */
+    if ((0 >= polp->faceN) && (0 >= poln->faceN)) { /* sphere and sphere */
+        for (int s = 0; s < DIMS; ++s) {
+            N[s] = nd[s] ? poln->O[s] - polp->O[s] : zero;
+        }
+        gap = Norm(N) - polp->r - poln->r;
+    } else { /* sphere and triangulated polyhedron */
+        const Polyhedron *const sph = (0 >= polp->faceN) ? polp : poln;
+        const Polyhedron *const stl = (0 >= polp->faceN) ? poln : polp;
+        ComputeIntersection(sph->O, FindClosestFace(sph->O, stl), stl, pi, N);
+        gap = Dist(sph->O, pi);
+        for (int s = 0; s < DIMS; ++s) {
+            pi[s] = sph->O[s] - pi[s];
+        }
+        if (zero > Dot(pi, N)) { /* sphere center inside */
+            gap = -gap;
+        }
+        gap = gap - sph->r;
+        for (int s = 0; s < DIMS; ++s) { /* outward normal points to the sphere */
+            N[s] = nd[s] ? ((sph == polp) ? -N[s] : N[s]) : zero;
+        }
+    }
+    if ((h < gap) || (zero == Norm(N))) {
+        return 0;
+    }
+    return 1;
+}
 static void DetectColState(const int k, const int j, const int i, const int did,
-        const int end, const int path[restrict][DIMS], const Node *const node,
+        const int end, const int path[restrict][DIMS], const Field *const field,
         const Partition *const part, Geometry *const geo)
 {
     /* search around the specified node to find colliding objects */
@@ -346,27 +464,32 @@ static void DetectColState(const int k, const int j, const int i, const int did,
             continue;
         }
         idx = IndexNode(kh, jh, ih, part->n[Y], part->n[X]);
-        if (0 == node[idx].did) { /* a fluid node is not valid */
+        if (0 == field->did[idx]) { /* a fluid node is not valid */
             continue;
         }
-        if (did != node[idx].did) { /* a heterogeneous node on the path */
-            AddColObject(path[n], node[idx].did, geo);
+        if (0 >= geo->poly[field->did[idx] - 1].faceN) { /* analytical polyhedron is detected analytically */
+            continue;
+        }
+        if (did != field->did[idx]) { /* a heterogeneous node on the path */
+            AddColObject(path[n], field->did[idx], geo);
         }
     }
     return;
 }
+/*
+ * The slot of an object is only trusted when it points into the current list
+ * at an entry of the same object, hence slots never need to be reset when
+ * the list is.
+ */
 static void AddColObject(const int N[restrict], const int did, Geometry *const geo)
 {
-    Collision *col = NULL;
-    /* search the object list, if already exist, adjust the line of impact */
-    for (int n = 0; n < geo->colN; ++n) {
-        col = geo->col + n;
-        if (did == col->gid) {
-            col->N[X] = col->N[X] + N[X];
-            col->N[Y] = col->N[Y] + N[Y];
-            col->N[Z] = col->N[Z] + N[Z];
-            return;
-        }
+    Collision *col = geo->col + geo->slot[did];
+    /* if the object already exists, adjust the line of impact */
+    if ((geo->colN > geo->slot[did]) && (did == col->gid)) {
+        col->N[X] = col->N[X] + N[X];
+        col->N[Y] = col->N[Y] + N[Y];
+        col->N[Z] = col->N[Z] + N[Z];
+        return;
     }
     /* otherwise, add to the collision list */
     col = geo->col + geo->colN;
@@ -374,6 +497,7 @@ static void AddColObject(const int N[restrict], const int did, Geometry *const g
     col->N[X] = N[X];
     col->N[Y] = N[Y];
     col->N[Z] = N[Z];
+    geo->slot[did] = geo->colN;
     ++(geo->colN);
     return;
 }
@@ -62,6 +62,7 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
     /* time instants interval and recorder */
     const Real tmInt = (INT_MAX == time->dataW[PROSD]) ? time->end : dtData[PROSD]; /* a specific instant */
     Real rcInt = zero; /* time instant recorder */
+    StartDataPipeline(time, space, model);
     while ((time->now < time->end) && (time->stepC < time->stepN)) {
         ++(time->stepC);
         dt = ComputeTimeStep(time, space, model);
@@ -82,7 +83,7 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
         if (0 != model->psi) {
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
         }
-        EvolveFluidDynamics(dt, space, model);
+        EvolveFluidDynamics(time->stepC, dt, space, model);
         if (0 != model->psi) {
             EvolveSolidDynamics(time->now, 0.5 * dt, space, model);
         }
@@ -103,20 +104,18 @@ static void EvolveSolution(Time *time, Space *space, const Model *model)
             }
         }
     }
+    FinishDataPipeline();
     return;
 }
 static Real ComputeTimeStep(const Time *time, const Space *space, const Model *model)
 {
     const Partition *const part = &(space->part);
-    const Node *const node = space->node;
+    const Field *const field = &(space->field);
     const Geometry *const geo = &(space->geo);
     const Polyhedron *poly = NULL;
-    const Real *restrict U = NULL;
-    Real Uo[DIMUo] = {0.0};
-    int idx = 0; /* linear array index math variable */
-    Real c = 0.0; /* speed of sound */
     RealVec V = {0.0}; /* characteristic speeds in each direction */
     RealVec Vmax = {0.0}; /* maximum characteristic speeds in each direction */
+    Real numCFL = time->numCFL; /* CFL number of the applied schemes */
     /* incorporate solid dynamics into CFL condition */
     for (int n = 0; n < geo->totN; ++n) {
         poly = geo->poly + n;
@@ -129,27 +128,40 @@ static Real ComputeTimeStep(const Time *time, const Space *space, const Model *m
             }
         }
     }
-    /* incorporate fluid dynamics into CFL condition */
-    for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
-        for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
-            for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
-                idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
-                U = node[idx].U[TO];
-                if (0 != node[idx].did) {
-                    continue;
-                }
-                MapPrimitive(model->gamma, model->gasR, U, Uo);
-                c = sqrt(model->gamma * model->gasR * Uo[5]);
-                for (int s = 0; s < DIMS; ++s) {
-                    V[s] = fabs(Uo[s+1]) + c;
-                    if (Vmax[s] < V[s]) {
-                        Vmax[s] = V[s];
+    /*
+     * Incorporate fluid dynamics into CFL condition. The maximum is exact
+     * for any reduction order, hence threads do not affect the result.
+     * The speeds are taken from the final update of the fluid nodes when
+     * available, otherwise the fluid nodes are scanned.
+     */
+    if (TO == field->tv) {
+        for (int s = 0; s < DIMS; ++s) {
+            Vmax[s] = MaxReal(Vmax[s], field->vmax[s]);
+        }
+    } else {
+#pragma omp parallel for collapse(2) schedule(static) reduction(max:Vmax[:DIMS])
+        for (int k = part->ns[PIN][Z][MIN]; k < part->ns[PIN][Z][MAX]; ++k) {
+            for (int j = part->ns[PIN][Y][MIN]; j < part->ns[PIN][Y][MAX]; ++j) {
+                Real Uo[DIMUo] = {0.0};
+                int idx = 0; /* linear array index math variable */
+                for (int i = part->ns[PIN][X][MIN]; i < part->ns[PIN][X][MAX]; ++i) {
+                    idx = IndexNode(k, j, i, part->n[Y], part->n[X]);
+                    if (0 != field->did[idx]) {
+                        continue;
                     }
+                    LoadPrimitive(TO, idx, field, model, Uo);
+                    MaxCharacteristicSpeed(model->gamma, model->gasR, Uo, Vmax);
                 }
             }
         }
     }
-    return time->numCFL * MinReal(part->d[X] / Vmax[X], MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z]));
+    if (OPTSTRANG == model->multidim) { /* full-step sweeps */
+        numCFL = 0.5 * numCFL;
+    }
+    if (RKTHREELS == model->tScheme) { /* SSP coefficient relative to RK3 */
+        numCFL = 0.32 * numCFL;
+    }
+    return numCFL * MinReal(part->d[X] / Vmax[X], MinReal(part->d[Y] / Vmax[Y], part->d[Z] / Vmax[Z]));
 }
 /* a good practice: end file with a newline */
 
@@ -20,6 +20,20 @@
 /****************************************************************************
  * Data Structure Declarations
  ****************************************************************************/
+typedef enum {
+    WENOLANE = 8, /* lanes per SIMD block, the lane count of a batch must be a multiple */
+} WENOBatchConst;
+/*
+ * Batched kernels use GCC vector extensions and are cloned for AVX-512,
+ * AVX2, and the SSE2 baseline, with the clone selected by the running
+ * processor at load time. Otherwise, lanes are reconstructed one by one.
+ */
+#if defined(__GNUC__) && !defined(__INTEL_COMPILER) && defined(__x86_64__)
+#define WENO_SIMD_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#define WENO_SIMD 1
+#else
+#define WENO_SIMD 0
+#endif
 /****************************************************************************
  * Public Functions Declaration
  ****************************************************************************/
@@ -31,6 +45,19 @@
  */
 extern void WENO3(Real F[restrict][DIMU], Real Fhat[restrict]);
 extern void WENO5(Real F[restrict][DIMU], Real Fhat[restrict]);
+/*
+ * Batched WENO
+ *
+ * Function
+ *      Reconstruct the numerical fluxes of n lanes at once. The stencil is
+ *      stored in structure of arrays as H[s*ld+l] for stencil node s of lane
+ *      l, and n should be a multiple of WENOLANE. Results are bitwise
+ *      identical to the scalar reconstruction of each lane.
+ */
+extern void WENO3Batch(const int n, const int ld, const Real H[restrict],
+        Real Hhat[restrict]);
+extern void WENO5Batch(const int n, const int ld, const Real H[restrict],
+        Real Hhat[restrict]);
 #endif
 /* a good practice: end file with a newline */
 
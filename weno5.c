@@ -12,6 +12,7 @@
  * Required Header Files
  ****************************************************************************/
 #include "weno.h"
+#include <string.h> /* manipulating strings */
 #include "cfd_commons.h"
 #include "commons.h"
 /****************************************************************************
@@ -25,6 +26,7 @@ typedef enum {
  * Static Function Declarations
  ****************************************************************************/
 static Real Square(const Real);
+static Real ReconstructValue(const Real, const Real, const Real, const Real, const Real);
 /****************************************************************************
  * Function definitions
  ****************************************************************************/
@@ -33,6 +35,65 @@ static Real Square(const Real);
  * ENO Schemes. Journal of Computational Physics, 126(1), pp.202-228.
  */
 void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
+{
+    for (int r = 0; r < DIMU; ++r) {
+        Fhat[r] = ReconstructValue(F[CN-2][r], F[CN-1][r], F[CN][r], F[CN+1][r], F[CN+2][r]);
+    }
+    return;
+}
+#if WENO_SIMD
+/*
+ * The vector kernel repeats the operations of ReconstructValue in the same
+ * order, therefore each lane rounds exactly as the scalar reconstruction.
+ */
+typedef Real WenoVec __attribute__((vector_size(WENOLANE * sizeof(Real))));
+WENO_SIMD_CLONES
+void WENO5Batch(const int n, const int ld, const Real H[restrict], Real Hhat[restrict])
+{
+    const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
+    const Real epsilon = 1.0e-6;
+    WenoVec F[2*R-1]; /* stencil */
+    WenoVec IS[R]; /* smoothness measurements */
+    WenoVec alpha[R];
+    WenoVec q[R]; /* q vectors */
+    WenoVec T[2];
+    for (int l = 0; l < n; l = l + WENOLANE) {
+        for (int s = 0; s < 2 * R - 1; ++s) {
+            memcpy(F + s, H + s * ld + l, sizeof(WenoVec));
+        }
+        T[0] = F[CN-2] - 2.0 * F[CN-1] + F[CN];
+        T[1] = F[CN-2] - 4.0 * F[CN-1] + 3.0 * F[CN];
+        IS[0] = (13.0 / 12.0) * (T[0] * T[0]) + (1.0 / 4.0) * (T[1] * T[1]);
+        T[0] = F[CN-1] - 2.0 * F[CN] + F[CN+1];
+        T[1] = F[CN-1] - F[CN+1];
+        IS[1] = (13.0 / 12.0) * (T[0] * T[0]) + (1.0 / 4.0) * (T[1] * T[1]);
+        T[0] = F[CN] - 2.0 * F[CN+1] + F[CN+2];
+        T[1] = 3.0 * F[CN] - 4.0 * F[CN+1] + F[CN+2];
+        IS[2] = (13.0 / 12.0) * (T[0] * T[0]) + (1.0 / 4.0) * (T[1] * T[1]);
+        for (int r = 0; r < R; ++r) {
+            T[0] = epsilon + IS[r];
+            alpha[r] = C[r] / (T[0] * T[0]);
+        }
+        T[0] = alpha[0] + alpha[1] + alpha[2];
+        q[0] = (1.0 / 6.0) * (2.0 * F[CN-2] - 7.0 * F[CN-1] + 11.0 * F[CN]);
+        q[1] = (1.0 / 6.0) * (-F[CN-1] + 5.0 * F[CN] + 2.0 * F[CN+1]);
+        q[2] = (1.0 / 6.0) * (2.0 * F[CN] + 5.0 * F[CN+1] - F[CN+2]);
+        T[1] = (alpha[0] / T[0]) * q[0] + (alpha[1] / T[0]) * q[1] + (alpha[2] / T[0]) * q[2];
+        memcpy(Hhat + l, T + 1, sizeof(WenoVec));
+    }
+    return;
+}
+#else
+void WENO5Batch(const int n, const int ld, const Real H[restrict], Real Hhat[restrict])
+{
+    for (int l = 0; l < n; ++l) {
+        Hhat[l] = ReconstructValue(H[l], H[ld+l], H[2*ld+l], H[3*ld+l], H[4*ld+l]);
+    }
+    return;
+}
+#endif
+static Real ReconstructValue(const Real f0, const Real f1, const Real f2, const Real f3,
+        const Real f4)
 {
     Real omega[R]; /* weights */
     Real q[R]; /* q vectors */
@@ -40,25 +101,22 @@ void WENO5(Real F[restrict][DIMU], Real Fhat[restrict])
     Real alpha[R];
     const Real C[R] = {1.0 / 10.0, 6.0 / 10.0, 3.0 / 10.0};
     const Real epsilon = 1.0e-6;
-    for (int r = 0; r < DIMU; ++r) {
-        IS[0] = (13.0 / 12.0) * Square(F[CN-2][r] - 2.0 * F[CN-1][r] + F[CN][r]) +
-            (1.0 / 4.0) * Square(F[CN-2][r] - 4.0 * F[CN-1][r] + 3.0 * F[CN][r]);
-        IS[1] = (13.0 / 12.0) * Square(F[CN-1][r] - 2.0 * F[CN][r] + F[CN+1][r]) +
-            (1.0 / 4.0) * Square(F[CN-1][r] - F[CN+1][r]);
-        IS[2] = (13.0 / 12.0) * Square(F[CN][r] - 2.0 * F[CN+1][r] + F[CN+2][r]) +
-            (1.0 / 4.0) * Square(3.0 * F[CN][r] - 4.0 * F[CN+1][r] + F[CN+2][r]);
-        alpha[0] = C[0] / Square(epsilon + IS[0]);
-        alpha[1] = C[1] / Square(epsilon + IS[1]);
-        alpha[2] = C[2] / Square(epsilon + IS[2]);
-        omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
-        omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
-        q[0] = (1.0 / 6.0) * (2.0 * F[CN-2][r] - 7.0 * F[CN-1][r] + 11.0 * F[CN][r]);
-        q[1] = (1.0 / 6.0) * (-F[CN-1][r] + 5.0 * F[CN][r] + 2.0 * F[CN+1][r]);
-        q[2] = (1.0 / 6.0) * (2.0 * F[CN][r] + 5.0 * F[CN+1][r] - F[CN+2][r]);
-        Fhat[r] = omega[0] * q[0] + omega[1] * q[1] + omega[2] * q[2];
-    }
-    return;
+    IS[0] = (13.0 / 12.0) * Square(f0 - 2.0 * f1 + f2) +
+        (1.0 / 4.0) * Square(f0 - 4.0 * f1 + 3.0 * f2);
+    IS[1] = (13.0 / 12.0) * Square(f1 - 2.0 * f2 + f3) +
+        (1.0 / 4.0) * Square(f1 - f3);
+    IS[2] = (13.0 / 12.0) * Square(f2 - 2.0 * f3 + f4) +
+        (1.0 / 4.0) * Square(3.0 * f2 - 4.0 * f3 + f4);
+    alpha[0] = C[0] / Square(epsilon + IS[0]);
+    alpha[1] = C[1] / Square(epsilon + IS[1]);
+    alpha[2] = C[2] / Square(epsilon + IS[2]);
+    omega[0] = alpha[0] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[1] = alpha[1] / (alpha[0] + alpha[1] + alpha[2]);
+    omega[2] = alpha[2] / (alpha[0] + alpha[1] + alpha[2]);
+    q[0] = (1.0 / 6.0) * (2.0 * f0 - 7.0 * f1 + 11.0 * f2);
+    q[1] = (1.0 / 6.0) * (-f1 + 5.0 * f2 + 2.0 * f3);
+    q[2] = (1.0 / 6.0) * (2.0 * f2 + 5.0 * f3 - f4);
+    return omega[0] * q[0] + omega[1] * q[1] + omega[2] * q[2];
 }
 static Real Square(const Real x)
 {